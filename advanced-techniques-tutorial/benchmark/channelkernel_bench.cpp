@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "gainkernel.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+constexpr int32 kBlockSize = 256;
+constexpr double kSecondsToProcess = 0.25;
+
+//------------------------------------------------------------------------
+struct Layout
+{
+	const char* name;
+	int32 numChannels;
+};
+
+// kStereo, k71_4 and 3rd order Ambisonics, plus the largest arrangement possible
+constexpr Layout layouts[] = {{"stereo", 2}, {"7.1.4", 12}, {"ambi3", 16}, {"64ch", 64}};
+
+//------------------------------------------------------------------------
+// The previous implementation: one kernel call per channel.
+//------------------------------------------------------------------------
+template <typename SampleType>
+void perChannelKernel (std::vector<SampleType*>& inputs, std::vector<SampleType*>& outputs,
+                       double gainStart, double gainIncrement)
+{
+	for (auto channelIndex = 0u; channelIndex < inputs.size (); ++channelIndex)
+		applyGainRamp (inputs[channelIndex], outputs[channelIndex], kBlockSize, gainStart,
+		               gainIncrement);
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void multiChannelKernel (std::vector<SampleType*>& inputs, std::vector<SampleType*>& outputs,
+                         double gainStart, double gainIncrement)
+{
+	applyGainRamp (inputs.data (), outputs.data (), static_cast<int32> (inputs.size ()), 0,
+	               kBlockSize, gainStart, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType, typename Proc>
+double measureNanosecondsPerChannelSample (int32 numChannels, Proc proc)
+{
+	std::vector<std::vector<SampleType>> inputData (numChannels,
+	                                                std::vector<SampleType> (kBlockSize, 0.5));
+	std::vector<std::vector<SampleType>> outputData (numChannels,
+	                                                 std::vector<SampleType> (kBlockSize));
+	std::vector<SampleType*> inputs;
+	std::vector<SampleType*> outputs;
+	for (auto channelIndex = 0; channelIndex < numChannels; ++channelIndex)
+	{
+		inputs.push_back (inputData[channelIndex].data ());
+		outputs.push_back (outputData[channelIndex].data ());
+	}
+
+	// process the same number of channel samples for every layout
+	auto numBlocks = static_cast<int64> (kSecondsToProcess * 48000. * 64. / kBlockSize);
+	numBlocks = numBlocks * 16 / numChannels;
+	auto start = std::chrono::steady_clock::now ();
+	for (int64 blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+	{
+		auto gainStart = (blockIndex & 1) ? 1. : 0.25;
+		auto gainEnd = (blockIndex & 1) ? 0.25 : 1.;
+		proc (inputs, outputs, gainStart, (gainEnd - gainStart) / kBlockSize);
+	}
+	auto end = std::chrono::steady_clock::now ();
+
+	// make sure the compiler cannot discard the output
+	volatile SampleType sink = outputData[numChannels - 1][kBlockSize / 2];
+	(void)sink;
+
+	auto nanoseconds = std::chrono::duration<double, std::nano> (end - start).count ();
+	return nanoseconds / (static_cast<double> (numBlocks) * kBlockSize * numChannels);
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void runBenchmark (const char* sampleTypeName)
+{
+	for (const auto& layout : layouts)
+	{
+		auto perChannel = measureNanosecondsPerChannelSample<SampleType> (
+		    layout.numChannels, perChannelKernel<SampleType>);
+		auto multiChannel = measureNanosecondsPerChannelSample<SampleType> (
+		    layout.numChannels, multiChannelKernel<SampleType>);
+		std::printf ("%-7s %-7s %4d %16.3f %16.3f %8.2fx\n", sampleTypeName, layout.name,
+		             layout.numChannels, perChannel, multiChannel, perChannel / multiChannel);
+	}
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main ()
+{
+	std::printf ("gain kernel: %s, block size %d\n\n", getGainKernelName (), kBlockSize);
+	std::printf ("%-7s %-7s %4s %16s %16s %9s\n", "type", "layout", "ch", "per channel ns",
+	             "multi channel ns", "speedup");
+	runBenchmark<float> ("float");
+	runBenchmark<double> ("double");
+	return 0;
+}
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "gainkernel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+constexpr int32 kNumChannels = 2;
+constexpr int32 kSliceSize = 8;
+constexpr double kSecondsToProcess = 0.25;
+
+//------------------------------------------------------------------------
+// The previous implementation: the block is cut into slices of 8 samples and every slice is
+// processed with a constant gain.
+//------------------------------------------------------------------------
+template <typename SampleType>
+void slicedGainLoop (std::vector<SampleType*>& inputs, std::vector<SampleType*>& outputs,
+                     int32 numSamples, double gainStart, double gainEnd)
+{
+	auto gainIncrement = (gainEnd - gainStart) / numSamples;
+	for (auto offset = 0; offset < numSamples; offset += kSliceSize)
+	{
+		auto sliceSize = std::min (kSliceSize, numSamples - offset);
+		auto gain = gainStart + (offset + sliceSize) * gainIncrement;
+		for (auto channelIndex = 0u; channelIndex < inputs.size (); ++channelIndex)
+		{
+			auto inputBuffers = inputs[channelIndex] + offset;
+			auto outputBuffers = outputs[channelIndex] + offset;
+			for (auto sampleIndex = 0; sampleIndex < sliceSize; ++sampleIndex)
+				outputBuffers[sampleIndex] = static_cast<SampleType> (inputBuffers[sampleIndex] * gain);
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void gainRampKernel (std::vector<SampleType*>& inputs, std::vector<SampleType*>& outputs,
+                     int32 numSamples, double gainStart, double gainEnd)
+{
+	auto gainIncrement = (gainEnd - gainStart) / numSamples;
+	for (auto channelIndex = 0u; channelIndex < inputs.size (); ++channelIndex)
+		applyGainRamp (inputs[channelIndex], outputs[channelIndex], numSamples, gainStart,
+		               gainIncrement);
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType, typename Proc>
+double measureNanosecondsPerSample (int32 blockSize, Proc proc)
+{
+	std::vector<std::vector<SampleType>> inputData (kNumChannels,
+	                                                std::vector<SampleType> (blockSize, 0.5));
+	std::vector<std::vector<SampleType>> outputData (kNumChannels,
+	                                                 std::vector<SampleType> (blockSize));
+	std::vector<SampleType*> inputs;
+	std::vector<SampleType*> outputs;
+	for (auto channelIndex = 0; channelIndex < kNumChannels; ++channelIndex)
+	{
+		inputs.push_back (inputData[channelIndex].data ());
+		outputs.push_back (outputData[channelIndex].data ());
+	}
+
+	auto numBlocks = static_cast<int64> (kSecondsToProcess * 48000. * 64. / blockSize);
+	auto start = std::chrono::steady_clock::now ();
+	for (int64 blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+	{
+		// alternate between a ramp up and a ramp down
+		auto gainStart = (blockIndex & 1) ? 1. : 0.25;
+		auto gainEnd = (blockIndex & 1) ? 0.25 : 1.;
+		proc (inputs, outputs, blockSize, gainStart, gainEnd);
+	}
+	auto end = std::chrono::steady_clock::now ();
+
+	// make sure the compiler cannot discard the output
+	volatile SampleType sink = outputData[0][blockSize / 2];
+	(void)sink;
+
+	auto nanoseconds = std::chrono::duration<double, std::nano> (end - start).count ();
+	return nanoseconds / (static_cast<double> (numBlocks) * blockSize * kNumChannels);
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void runBenchmark (const char* sampleTypeName)
+{
+	for (auto blockSize : {32, 64, 128, 256, 512, 1024, 4096})
+	{
+		auto sliced = measureNanosecondsPerSample<SampleType> (blockSize,
+		                                                       slicedGainLoop<SampleType>);
+		auto kernel = measureNanosecondsPerSample<SampleType> (blockSize,
+		                                                       gainRampKernel<SampleType>);
+		std::printf ("%-7s %6d %14.3f %14.3f %8.2fx\n", sampleTypeName, blockSize, sliced, kernel,
+		             sliced / kernel);
+	}
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main ()
+{
+	std::printf ("gain kernel: %s\n\n", getGainKernelName ());
+	std::printf ("%-7s %6s %14s %14s %9s\n", "type", "block", "sliced ns/smp", "kernel ns/smp",
+	             "speedup");
+	runBenchmark<float> ("float");
+	runBenchmark<double> ("double");
+	return 0;
+}
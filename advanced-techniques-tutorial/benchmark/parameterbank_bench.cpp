@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "parameterbank.h"
+#include "public.sdk/source/vst/utility/sampleaccurate.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+constexpr int32 kBlockSize = 256;
+constexpr int32 kSliceSize = 8;
+constexpr int32 kPointsPerBlock = 4;
+constexpr int64 kNumBlocks = 20000;
+// parameter IDs are not contiguous in real plug-ins
+constexpr ParamID kFirstParamID = 1000;
+constexpr ParamID kParamIDStride = 7;
+
+//------------------------------------------------------------------------
+class BenchParamValueQueue : public IParamValueQueue
+{
+public:
+	explicit BenchParamValueQueue (ParamID paramID) : paramID (paramID) {}
+
+	void setBlock (int64 blockIndex)
+	{
+		for (auto index = 0; index < kPointsPerBlock; ++index)
+		{
+			offsets[index] = (index + 1) * kBlockSize / kPointsPerBlock - 1;
+			values[index] = ((blockIndex + index) & 1) ? 0.25 : 0.75;
+		}
+	}
+
+	ParamID PLUGIN_API getParameterId () override { return paramID; }
+	int32 PLUGIN_API getPointCount () override { return kPointsPerBlock; }
+	tresult PLUGIN_API getPoint (int32 index, int32& sampleOffset, ParamValue& value) override
+	{
+		if (index < 0 || index >= kPointsPerBlock)
+			return kResultFalse;
+		sampleOffset = offsets[index];
+		value = values[index];
+		return kResultTrue;
+	}
+	tresult PLUGIN_API addPoint (int32, ParamValue, int32&) override { return kResultFalse; }
+
+	tresult PLUGIN_API queryInterface (const TUID, void**) override { return kNoInterface; }
+	uint32 PLUGIN_API addRef () override { return 1; }
+	uint32 PLUGIN_API release () override { return 1; }
+
+private:
+	ParamID paramID;
+	int32 offsets[kPointsPerBlock] {};
+	ParamValue values[kPointsPerBlock] {};
+};
+
+//------------------------------------------------------------------------
+class BenchParameterChanges : public IParameterChanges
+{
+public:
+	std::vector<BenchParamValueQueue> queues;
+
+	int32 PLUGIN_API getParameterCount () override { return static_cast<int32> (queues.size ()); }
+	IParamValueQueue* PLUGIN_API getParameterData (int32 index) override { return &queues[index]; }
+	IParamValueQueue* PLUGIN_API addParameterData (const ParamID&, int32&) override
+	{
+		return nullptr;
+	}
+
+	tresult PLUGIN_API queryInterface (const TUID, void**) override { return kNoInterface; }
+	uint32 PLUGIN_API addRef () override { return 1; }
+	uint32 PLUGIN_API release () override { return 1; }
+};
+
+//------------------------------------------------------------------------
+// The previous approach generalized to many parameters: the queues are routed by searching the
+// parameter ID, and every parameter is advanced in every 8 sample slice.
+//------------------------------------------------------------------------
+struct ParameterList
+{
+	std::vector<SampleAccurate::Parameter> parameters;
+
+	void processBlock (IParameterChanges* changes, double& sink)
+	{
+		for (auto index = 0; index < changes->getParameterCount (); ++index)
+		{
+			auto queue = changes->getParameterData (index);
+			for (auto& parameter : parameters)
+			{
+				if (parameter.getParamID () == queue->getParameterId ())
+				{
+					parameter.beginChanges (queue);
+					break;
+				}
+			}
+		}
+		for (auto offset = 0; offset < kBlockSize; offset += kSliceSize)
+		{
+			for (auto& parameter : parameters)
+				sink += parameter.advance (kSliceSize);
+		}
+		for (auto& parameter : parameters)
+			parameter.endChanges ();
+	}
+};
+
+//------------------------------------------------------------------------
+struct ParameterBankProcessor
+{
+	ParameterBank bank;
+
+	void processBlock (IParameterChanges* changes, double& sink)
+	{
+		bank.beginChanges (changes);
+		auto offset = 0;
+		while (offset < kBlockSize)
+		{
+			auto sliceEnd = bank.getNextChangeOffset (kBlockSize);
+			bank.advance (sliceEnd - offset);
+			bank.forEachChanged ([&] (uint32 slot) { sink += bank.getValue (slot); });
+			offset = sliceEnd;
+		}
+		bank.endChanges ();
+	}
+};
+
+//------------------------------------------------------------------------
+template <typename Processor>
+double measureNanosecondsPerBlock (Processor& processor, BenchParameterChanges& changes)
+{
+	double sink = 0.;
+	auto start = std::chrono::steady_clock::now ();
+	for (int64 blockIndex = 0; blockIndex < kNumBlocks; ++blockIndex)
+	{
+		for (auto& queue : changes.queues)
+			queue.setBlock (blockIndex);
+		processor.processBlock (&changes, sink);
+	}
+	auto end = std::chrono::steady_clock::now ();
+
+	// make sure the compiler cannot discard the work
+	volatile double result = sink;
+	(void)result;
+
+	return std::chrono::duration<double, std::nano> (end - start).count () / kNumBlocks;
+}
+
+//------------------------------------------------------------------------
+void runBenchmark (int32 numParameters, int32 numChanged)
+{
+	ParameterList list;
+	ParameterBankProcessor bankProcessor;
+	BenchParameterChanges changes;
+	for (auto index = 0; index < numParameters; ++index)
+	{
+		auto paramID = kFirstParamID + index * kParamIDStride;
+		list.parameters.emplace_back (paramID, 0.5);
+		bankProcessor.bank.addParameter (paramID, 0.5);
+	}
+	// the changed parameters are spread over the whole range
+	for (auto index = 0; index < numChanged; ++index)
+	{
+		auto paramIndex = index * numParameters / numChanged;
+		changes.queues.emplace_back (kFirstParamID + paramIndex * kParamIDStride);
+	}
+
+	auto listTime = measureNanosecondsPerBlock (list, changes);
+	auto bankTime = measureNanosecondsPerBlock (bankProcessor, changes);
+	std::printf ("%6d %8d %14.1f %14.1f %8.2fx\n", numParameters, numChanged, listTime, bankTime,
+	             listTime / bankTime);
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main ()
+{
+	std::printf ("block size %d, %d points per changed parameter\n\n", kBlockSize,
+	             kPointsPerBlock);
+	std::printf ("%6s %8s %14s %14s %9s\n", "params", "changed", "list ns/block", "bank ns/block",
+	             "speedup");
+	for (auto numParameters : {1, 16, 256})
+	{
+		runBenchmark (numParameters, 1);
+		if (numParameters > 1)
+			runBenchmark (numParameters, numParameters / 4);
+		if (numParameters > 4)
+			runBenchmark (numParameters, numParameters);
+	}
+	return 0;
+}
@@ -3,8 +3,8 @@
 //------------------------------------------------------------------------
 
 #include "pids.h"
+#include "stateformat.h"
 #include "public.sdk/source/vst/vsteditcontroller.h"
-#include "base/source/fstreamer.h"
 
 //------------------------------------------------------------------------
 namespace Steinberg::Tutorial {
@@ -37,14 +37,15 @@ tresult PLUGIN_API Controller::setComponentState (IBStream* state)
 	if (!state)
 		return kInvalidArgument;
 
-	IBStreamer streamer (state, kLittleEndian);
-
-	ParamValue value;
-	if (!streamer.readDouble (value))
+	std::vector<StateParameter> stateParameters;
+	if (readState (state, stateParameters) != kResultTrue)
 		return kResultFalse;
 
-	if (auto param = parameters.getParameter (ParameterID::Gain))
-		param->setNormalized (value);
+	for (const auto& stateParameter : stateParameters)
+	{
+		if (auto param = parameters.getParameter (stateParameter.id))
+			param->setNormalized (stateParameter.value);
+	}
 	return kResultTrue;
 }
 
@@ -0,0 +1,408 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "gainkernel.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TUTORIAL_GAINKERNEL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TUTORIAL_TARGET_AVX2
+#else
+#define TUTORIAL_TARGET_AVX2 __attribute__ ((target ("avx2")))
+#endif
+#else
+#define TUTORIAL_GAINKERNEL_X86 0
+#endif
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void gainRampScalar (const SampleType* input, SampleType* output, int32 numSamples,
+                     double gainStart, double gainIncrement)
+{
+	for (auto sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		auto gain = gainStart + sampleIndex * gainIncrement;
+		output[sampleIndex] = static_cast<SampleType> (input[sampleIndex] * gain);
+	}
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void gainRampChannelsScalar (const SampleType* const* inputs, SampleType* const* outputs,
+                             int32 numChannels, int32 offset, int32 numSamples, double gainStart,
+                             double gainIncrement)
+{
+	for (auto channel = 0; channel < numChannels; ++channel)
+		gainRampScalar (inputs[channel] + offset, outputs[channel] + offset, numSamples, gainStart,
+		                gainIncrement);
+}
+
+// The multi channel kernels process the block in chunks of four vectors and apply the gain
+// vectors of a chunk to all channels. This only pays off while the block stays in the first
+// level cache, larger blocks are processed channel by channel to keep the accesses sequential.
+constexpr uint32 kCacheBudget = 32 * 1024;
+
+//------------------------------------------------------------------------
+inline bool fitsIntoCache (int32 numChannels, int32 numSamples, uint32 sampleSize)
+{
+	// input and output
+	return 2u * numChannels * numSamples * sampleSize <= kCacheBudget;
+}
+
+#if TUTORIAL_GAINKERNEL_X86
+//------------------------------------------------------------------------
+// The gain is computed as start + index * increment for every vector instead of summing up the
+// increments, so that the ramp does not drift on long blocks.
+//------------------------------------------------------------------------
+void gainRampSSE2 (const float* input, float* output, int32 numSamples, double gainStart,
+                   double gainIncrement)
+{
+	const auto start = _mm_set1_ps (static_cast<float> (gainStart));
+	const auto increment = _mm_set1_ps (static_cast<float> (gainIncrement));
+	const auto step = _mm_set1_ps (4.f);
+	auto index = _mm_setr_ps (0.f, 1.f, 2.f, 3.f);
+	auto sampleIndex = 0;
+	for (; sampleIndex + 4 <= numSamples; sampleIndex += 4)
+	{
+		auto gain = _mm_add_ps (start, _mm_mul_ps (index, increment));
+		auto samples = _mm_loadu_ps (input + sampleIndex);
+		_mm_storeu_ps (output + sampleIndex, _mm_mul_ps (samples, gain));
+		index = _mm_add_ps (index, step);
+	}
+	gainRampScalar (input + sampleIndex, output + sampleIndex, numSamples - sampleIndex,
+	                gainStart + sampleIndex * gainIncrement, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+void gainRampSSE2 (const double* input, double* output, int32 numSamples, double gainStart,
+                   double gainIncrement)
+{
+	const auto start = _mm_set1_pd (gainStart);
+	const auto increment = _mm_set1_pd (gainIncrement);
+	const auto step = _mm_set1_pd (2.);
+	auto index = _mm_setr_pd (0., 1.);
+	auto sampleIndex = 0;
+	for (; sampleIndex + 2 <= numSamples; sampleIndex += 2)
+	{
+		auto gain = _mm_add_pd (start, _mm_mul_pd (index, increment));
+		auto samples = _mm_loadu_pd (input + sampleIndex);
+		_mm_storeu_pd (output + sampleIndex, _mm_mul_pd (samples, gain));
+		index = _mm_add_pd (index, step);
+	}
+	gainRampScalar (input + sampleIndex, output + sampleIndex, numSamples - sampleIndex,
+	                gainStart + sampleIndex * gainIncrement, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+TUTORIAL_TARGET_AVX2 void gainRampAVX2 (const float* input, float* output, int32 numSamples,
+                                        double gainStart, double gainIncrement)
+{
+	const auto start = _mm256_set1_ps (static_cast<float> (gainStart));
+	const auto increment = _mm256_set1_ps (static_cast<float> (gainIncrement));
+	const auto step = _mm256_set1_ps (8.f);
+	auto index = _mm256_setr_ps (0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+	auto sampleIndex = 0;
+	for (; sampleIndex + 8 <= numSamples; sampleIndex += 8)
+	{
+		auto gain = _mm256_add_ps (start, _mm256_mul_ps (index, increment));
+		auto samples = _mm256_loadu_ps (input + sampleIndex);
+		_mm256_storeu_ps (output + sampleIndex, _mm256_mul_ps (samples, gain));
+		index = _mm256_add_ps (index, step);
+	}
+	gainRampScalar (input + sampleIndex, output + sampleIndex, numSamples - sampleIndex,
+	                gainStart + sampleIndex * gainIncrement, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+TUTORIAL_TARGET_AVX2 void gainRampAVX2 (const double* input, double* output, int32 numSamples,
+                                        double gainStart, double gainIncrement)
+{
+	const auto start = _mm256_set1_pd (gainStart);
+	const auto increment = _mm256_set1_pd (gainIncrement);
+	const auto step = _mm256_set1_pd (4.);
+	auto index = _mm256_setr_pd (0., 1., 2., 3.);
+	auto sampleIndex = 0;
+	for (; sampleIndex + 4 <= numSamples; sampleIndex += 4)
+	{
+		auto gain = _mm256_add_pd (start, _mm256_mul_pd (index, increment));
+		auto samples = _mm256_loadu_pd (input + sampleIndex);
+		_mm256_storeu_pd (output + sampleIndex, _mm256_mul_pd (samples, gain));
+		index = _mm256_add_pd (index, step);
+	}
+	gainRampScalar (input + sampleIndex, output + sampleIndex, numSamples - sampleIndex,
+	                gainStart + sampleIndex * gainIncrement, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+void gainRampChannelsSSE2 (const float* const* inputs, float* const* outputs,
+                           int32 numChannels, int32 offset, int32 numSamples, double gainStart,
+                           double gainIncrement)
+{
+	constexpr int32 kChunkSize = 4 * 4;
+	auto sampleIndex = 0;
+	if (fitsIntoCache (numChannels, numSamples, sizeof (float)))
+	{
+		const auto start = _mm_set1_ps (static_cast<float> (gainStart));
+		const auto increment = _mm_set1_ps (static_cast<float> (gainIncrement));
+		const auto firstIndex = _mm_setr_ps (0.f, 1.f, 2.f, 3.f);
+		const auto step = _mm_set1_ps (4.f);
+		for (; sampleIndex + kChunkSize <= numSamples; sampleIndex += kChunkSize)
+		{
+			// the four gain vectors of the chunk are shared by all channels
+			auto chunkStart = _mm_set1_ps (static_cast<float> (sampleIndex));
+			auto index = _mm_add_ps (firstIndex, chunkStart);
+			auto gain0 = _mm_add_ps (start, _mm_mul_ps (index, increment));
+			index = _mm_add_ps (index, step);
+			auto gain1 = _mm_add_ps (start, _mm_mul_ps (index, increment));
+			index = _mm_add_ps (index, step);
+			auto gain2 = _mm_add_ps (start, _mm_mul_ps (index, increment));
+			index = _mm_add_ps (index, step);
+			auto gain3 = _mm_add_ps (start, _mm_mul_ps (index, increment));
+			for (auto channel = 0; channel < numChannels; ++channel)
+			{
+				auto input = inputs[channel] + offset + sampleIndex;
+				auto output = outputs[channel] + offset + sampleIndex;
+				_mm_storeu_ps (output, _mm_mul_ps (_mm_loadu_ps (input), gain0));
+				_mm_storeu_ps (output + 4, _mm_mul_ps (_mm_loadu_ps (input + 4), gain1));
+				_mm_storeu_ps (output + 8, _mm_mul_ps (_mm_loadu_ps (input + 8), gain2));
+				_mm_storeu_ps (output + 12, _mm_mul_ps (_mm_loadu_ps (input + 12), gain3));
+			}
+		}
+	}
+	// the remaining samples and blocks exceeding the cache are processed channel by channel
+	for (auto channel = 0; channel < numChannels; ++channel)
+		gainRampSSE2 (inputs[channel] + offset + sampleIndex,
+		              outputs[channel] + offset + sampleIndex, numSamples - sampleIndex,
+		              gainStart + sampleIndex * gainIncrement, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+void gainRampChannelsSSE2 (const double* const* inputs, double* const* outputs,
+                           int32 numChannels, int32 offset, int32 numSamples, double gainStart,
+                           double gainIncrement)
+{
+	constexpr int32 kChunkSize = 4 * 2;
+	auto sampleIndex = 0;
+	if (fitsIntoCache (numChannels, numSamples, sizeof (double)))
+	{
+		const auto start = _mm_set1_pd (gainStart);
+		const auto increment = _mm_set1_pd (gainIncrement);
+		const auto firstIndex = _mm_setr_pd (0., 1.);
+		const auto step = _mm_set1_pd (2.);
+		for (; sampleIndex + kChunkSize <= numSamples; sampleIndex += kChunkSize)
+		{
+			// the four gain vectors of the chunk are shared by all channels
+			auto chunkStart = _mm_set1_pd (static_cast<double> (sampleIndex));
+			auto index = _mm_add_pd (firstIndex, chunkStart);
+			auto gain0 = _mm_add_pd (start, _mm_mul_pd (index, increment));
+			index = _mm_add_pd (index, step);
+			auto gain1 = _mm_add_pd (start, _mm_mul_pd (index, increment));
+			index = _mm_add_pd (index, step);
+			auto gain2 = _mm_add_pd (start, _mm_mul_pd (index, increment));
+			index = _mm_add_pd (index, step);
+			auto gain3 = _mm_add_pd (start, _mm_mul_pd (index, increment));
+			for (auto channel = 0; channel < numChannels; ++channel)
+			{
+				auto input = inputs[channel] + offset + sampleIndex;
+				auto output = outputs[channel] + offset + sampleIndex;
+				_mm_storeu_pd (output, _mm_mul_pd (_mm_loadu_pd (input), gain0));
+				_mm_storeu_pd (output + 2, _mm_mul_pd (_mm_loadu_pd (input + 2), gain1));
+				_mm_storeu_pd (output + 4, _mm_mul_pd (_mm_loadu_pd (input + 4), gain2));
+				_mm_storeu_pd (output + 6, _mm_mul_pd (_mm_loadu_pd (input + 6), gain3));
+			}
+		}
+	}
+	// the remaining samples and blocks exceeding the cache are processed channel by channel
+	for (auto channel = 0; channel < numChannels; ++channel)
+		gainRampSSE2 (inputs[channel] + offset + sampleIndex,
+		              outputs[channel] + offset + sampleIndex, numSamples - sampleIndex,
+		              gainStart + sampleIndex * gainIncrement, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+TUTORIAL_TARGET_AVX2 void gainRampChannelsAVX2 (const float* const* inputs,
+                                                float* const* outputs, int32 numChannels,
+                                                int32 offset, int32 numSamples, double gainStart,
+                                                double gainIncrement)
+{
+	constexpr int32 kChunkSize = 4 * 8;
+	auto sampleIndex = 0;
+	if (fitsIntoCache (numChannels, numSamples, sizeof (float)))
+	{
+		const auto start = _mm256_set1_ps (static_cast<float> (gainStart));
+		const auto increment = _mm256_set1_ps (static_cast<float> (gainIncrement));
+		const auto firstIndex = _mm256_setr_ps (0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+		const auto step = _mm256_set1_ps (8.f);
+		for (; sampleIndex + kChunkSize <= numSamples; sampleIndex += kChunkSize)
+		{
+			// the four gain vectors of the chunk are shared by all channels
+			auto chunkStart = _mm256_set1_ps (static_cast<float> (sampleIndex));
+			auto index = _mm256_add_ps (firstIndex, chunkStart);
+			auto gain0 = _mm256_add_ps (start, _mm256_mul_ps (index, increment));
+			index = _mm256_add_ps (index, step);
+			auto gain1 = _mm256_add_ps (start, _mm256_mul_ps (index, increment));
+			index = _mm256_add_ps (index, step);
+			auto gain2 = _mm256_add_ps (start, _mm256_mul_ps (index, increment));
+			index = _mm256_add_ps (index, step);
+			auto gain3 = _mm256_add_ps (start, _mm256_mul_ps (index, increment));
+			for (auto channel = 0; channel < numChannels; ++channel)
+			{
+				auto input = inputs[channel] + offset + sampleIndex;
+				auto output = outputs[channel] + offset + sampleIndex;
+				_mm256_storeu_ps (output, _mm256_mul_ps (_mm256_loadu_ps (input), gain0));
+				_mm256_storeu_ps (output + 8, _mm256_mul_ps (_mm256_loadu_ps (input + 8), gain1));
+				_mm256_storeu_ps (output + 16, _mm256_mul_ps (_mm256_loadu_ps (input + 16), gain2));
+				_mm256_storeu_ps (output + 24, _mm256_mul_ps (_mm256_loadu_ps (input + 24), gain3));
+			}
+		}
+	}
+	// the remaining samples and blocks exceeding the cache are processed channel by channel
+	for (auto channel = 0; channel < numChannels; ++channel)
+		gainRampAVX2 (inputs[channel] + offset + sampleIndex,
+		              outputs[channel] + offset + sampleIndex, numSamples - sampleIndex,
+		              gainStart + sampleIndex * gainIncrement, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+TUTORIAL_TARGET_AVX2 void gainRampChannelsAVX2 (const double* const* inputs,
+                                                double* const* outputs, int32 numChannels,
+                                                int32 offset, int32 numSamples, double gainStart,
+                                                double gainIncrement)
+{
+	constexpr int32 kChunkSize = 4 * 4;
+	auto sampleIndex = 0;
+	if (fitsIntoCache (numChannels, numSamples, sizeof (double)))
+	{
+		const auto start = _mm256_set1_pd (gainStart);
+		const auto increment = _mm256_set1_pd (gainIncrement);
+		const auto firstIndex = _mm256_setr_pd (0., 1., 2., 3.);
+		const auto step = _mm256_set1_pd (4.);
+		for (; sampleIndex + kChunkSize <= numSamples; sampleIndex += kChunkSize)
+		{
+			// the four gain vectors of the chunk are shared by all channels
+			auto chunkStart = _mm256_set1_pd (static_cast<double> (sampleIndex));
+			auto index = _mm256_add_pd (firstIndex, chunkStart);
+			auto gain0 = _mm256_add_pd (start, _mm256_mul_pd (index, increment));
+			index = _mm256_add_pd (index, step);
+			auto gain1 = _mm256_add_pd (start, _mm256_mul_pd (index, increment));
+			index = _mm256_add_pd (index, step);
+			auto gain2 = _mm256_add_pd (start, _mm256_mul_pd (index, increment));
+			index = _mm256_add_pd (index, step);
+			auto gain3 = _mm256_add_pd (start, _mm256_mul_pd (index, increment));
+			for (auto channel = 0; channel < numChannels; ++channel)
+			{
+				auto input = inputs[channel] + offset + sampleIndex;
+				auto output = outputs[channel] + offset + sampleIndex;
+				_mm256_storeu_pd (output, _mm256_mul_pd (_mm256_loadu_pd (input), gain0));
+				_mm256_storeu_pd (output + 4, _mm256_mul_pd (_mm256_loadu_pd (input + 4), gain1));
+				_mm256_storeu_pd (output + 8, _mm256_mul_pd (_mm256_loadu_pd (input + 8), gain2));
+				_mm256_storeu_pd (output + 12, _mm256_mul_pd (_mm256_loadu_pd (input + 12), gain3));
+			}
+		}
+	}
+	// the remaining samples and blocks exceeding the cache are processed channel by channel
+	for (auto channel = 0; channel < numChannels; ++channel)
+		gainRampAVX2 (inputs[channel] + offset + sampleIndex,
+		              outputs[channel] + offset + sampleIndex, numSamples - sampleIndex,
+		              gainStart + sampleIndex * gainIncrement, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+bool cpuSupportsAVX2 ()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid (info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid (info, 1);
+	constexpr auto osxsaveAndAVX = (1 << 27) | (1 << 28);
+	if ((info[2] & osxsaveAndAVX) != osxsaveAndAVX)
+		return false;
+	// the OS must save the YMM registers on context switches
+	if ((_xgetbv (0) & 6) != 6)
+		return false;
+	__cpuidex (info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init ();
+	return __builtin_cpu_supports ("avx2");
+#endif
+}
+#endif // TUTORIAL_GAINKERNEL_X86
+
+//------------------------------------------------------------------------
+struct GainKernel
+{
+	void (*process32) (const float*, float*, int32, double, double);
+	void (*process64) (const double*, double*, int32, double, double);
+	void (*processChannels32) (const float* const*, float* const*, int32, int32, int32, double,
+	                           double);
+	void (*processChannels64) (const double* const*, double* const*, int32, int32, int32, double,
+	                           double);
+	const char* name;
+};
+
+//------------------------------------------------------------------------
+GainKernel selectGainKernel ()
+{
+#if TUTORIAL_GAINKERNEL_X86
+	if (cpuSupportsAVX2 ())
+		return {gainRampAVX2, gainRampAVX2, gainRampChannelsAVX2, gainRampChannelsAVX2, "avx2"};
+	return {gainRampSSE2, gainRampSSE2, gainRampChannelsSSE2, gainRampChannelsSSE2, "sse2"};
+#else
+	return {gainRampScalar<float>, gainRampScalar<double>, gainRampChannelsScalar<float>,
+	        gainRampChannelsScalar<double>, "scalar"};
+#endif
+}
+
+static const GainKernel gainKernel = selectGainKernel ();
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+void applyGainRamp (const float* input, float* output, int32 numSamples, double gainStart,
+                    double gainIncrement)
+{
+	gainKernel.process32 (input, output, numSamples, gainStart, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+void applyGainRamp (const double* input, double* output, int32 numSamples, double gainStart,
+                    double gainIncrement)
+{
+	gainKernel.process64 (input, output, numSamples, gainStart, gainIncrement);
+}
+
+//------------------------------------------------------------------------
+void applyGainRamp (const float* const* inputs, float* const* outputs, int32 numChannels,
+                    int32 offset, int32 numSamples, double gainStart, double gainIncrement)
+{
+	gainKernel.processChannels32 (inputs, outputs, numChannels, offset, numSamples, gainStart,
+	                              gainIncrement);
+}
+
+//------------------------------------------------------------------------
+void applyGainRamp (const double* const* inputs, double* const* outputs, int32 numChannels,
+                    int32 offset, int32 numSamples, double gainStart, double gainIncrement)
+{
+	gainKernel.processChannels64 (inputs, outputs, numChannels, offset, numSamples, gainStart,
+	                              gainIncrement);
+}
+
+//------------------------------------------------------------------------
+const char* getGainKernelName ()
+{
+	return gainKernel.name;
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
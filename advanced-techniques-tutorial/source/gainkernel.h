@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/base/ftypes.h"
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+/** Multiplies the input samples with a linear gain ramp and writes them to the output.
+ *
+ *	The gain for sample i is gainStart + i * gainIncrement. Input and output may be the same
+ *	buffer. The implementation is chosen at runtime depending on the CPU (AVX2, SSE2 or scalar).
+ */
+void applyGainRamp (const float* input, float* output, int32 numSamples, double gainStart,
+                    double gainIncrement);
+void applyGainRamp (const double* input, double* output, int32 numSamples, double gainStart,
+                    double gainIncrement);
+
+//------------------------------------------------------------------------
+/** Applies the same gain ramp to the samples [offset, offset + numSamples) of numChannels channels.
+ *
+ *	While the block fits into the first level cache it is processed in chunks and the gain vectors
+ *	of a chunk are computed once for all channels, larger blocks are streamed channel by channel.
+ *	Input and output channels may be the same buffers.
+ */
+void applyGainRamp (const float* const* inputs, float* const* outputs, int32 numChannels,
+                    int32 offset, int32 numSamples, double gainStart, double gainIncrement);
+void applyGainRamp (const double* const* inputs, double* const* outputs, int32 numChannels,
+                    int32 offset, int32 numSamples, double gainStart, double gainIncrement);
+
+//------------------------------------------------------------------------
+/** Returns the name of the implementation chosen at runtime ("avx2", "sse2" or "scalar"). */
+const char* getGainKernelName ();
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
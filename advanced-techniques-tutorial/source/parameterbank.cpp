@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "parameterbank.h"
+#include <algorithm>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+using namespace Steinberg::Vst;
+
+//------------------------------------------------------------------------
+namespace {
+
+//------------------------------------------------------------------------
+inline uint32 hashParamID (ParamID paramID)
+{
+	// Fibonacci hashing, the table size is a power of two
+	return static_cast<uint32> (paramID) * 2654435769u;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+uint32 ParameterBank::addParameter (ParamID paramID, ParamValue initValue)
+{
+	if (getSlot (paramID) != kInvalidSlot)
+		return kInvalidSlot;
+
+	auto slot = getNumParameters ();
+	paramIDs.push_back (paramID);
+	values.push_back (initValue);
+	deltas.push_back (0.);
+	pointValues.push_back (initValue);
+	pointOffsets.push_back (kNoPoint);
+	pointIndices.push_back (0);
+	queues.push_back (nullptr);
+	changedSlots.resize ((paramIDs.size () + 63) / 64, 0);
+
+	rebuildLookup ();
+	return slot;
+}
+
+//------------------------------------------------------------------------
+void ParameterBank::rebuildLookup ()
+{
+	// keep the load factor at or below one half
+	uint32 tableSize = 4;
+	while (tableSize < paramIDs.size () * 2)
+		tableSize *= 2;
+
+	lookupMask = tableSize - 1;
+	lookupIDs.assign (tableSize, 0);
+	lookupSlots.assign (tableSize, kInvalidSlot);
+	for (auto slot = 0u; slot < paramIDs.size (); ++slot)
+	{
+		auto index = hashParamID (paramIDs[slot]) & lookupMask;
+		while (lookupSlots[index] != kInvalidSlot)
+			index = (index + 1) & lookupMask;
+		lookupIDs[index] = paramIDs[slot];
+		lookupSlots[index] = slot;
+	}
+}
+
+//------------------------------------------------------------------------
+uint32 ParameterBank::getSlot (ParamID paramID) const
+{
+	if (lookupSlots.empty ())
+		return kInvalidSlot;
+	auto index = hashParamID (paramID) & lookupMask;
+	while (lookupSlots[index] != kInvalidSlot)
+	{
+		if (lookupIDs[index] == paramID)
+			return lookupSlots[index];
+		index = (index + 1) & lookupMask;
+	}
+	return kInvalidSlot;
+}
+
+//------------------------------------------------------------------------
+bool ParameterBank::hasChanges (uint32 slot) const
+{
+	return (changedSlots[slot / 64] & (uint64 {1} << (slot % 64))) != 0;
+}
+
+//------------------------------------------------------------------------
+void ParameterBank::loadNextPoint (uint32 slot, int32 fromOffset)
+{
+	auto pointIndex = ++pointIndices[slot];
+	int32 sampleOffset;
+	ParamValue value;
+	if (pointIndex >= queues[slot]->getPointCount () ||
+	    queues[slot]->getPoint (pointIndex, sampleOffset, value) != kResultTrue)
+	{
+		// after the last point the value stays constant until the end of the block
+		pointOffsets[slot] = kNoPoint;
+		deltas[slot] = 0.;
+		return;
+	}
+	pointOffsets[slot] = std::max (sampleOffset, fromOffset);
+	pointValues[slot] = value;
+	auto distance = pointOffsets[slot] - fromOffset;
+	deltas[slot] = distance > 0 ? (value - values[slot]) / distance : 0.;
+}
+
+//------------------------------------------------------------------------
+void ParameterBank::advanceSlot (uint32 slot, int32 targetOffset)
+{
+	auto offset = position;
+	while (pointOffsets[slot] <= targetOffset)
+	{
+		offset = pointOffsets[slot];
+		values[slot] = pointValues[slot];
+		loadNextPoint (slot, offset);
+	}
+	values[slot] += deltas[slot] * (targetOffset - offset);
+}
+
+//------------------------------------------------------------------------
+void ParameterBank::beginChanges (IParameterChanges* changes)
+{
+	position = 0;
+	if (!changes)
+		return;
+	auto changeCount = changes->getParameterCount ();
+	for (auto index = 0; index < changeCount; ++index)
+	{
+		auto queue = changes->getParameterData (index);
+		if (!queue || queue->getPointCount () <= 0)
+			continue;
+		auto slot = getSlot (queue->getParameterId ());
+		if (slot == kInvalidSlot)
+			continue;
+
+		queues[slot] = queue;
+		pointIndices[slot] = -1;
+		changedSlots[slot / 64] |= uint64 {1} << (slot % 64);
+		loadNextPoint (slot, 0);
+		// points at offset zero take effect immediately
+		advanceSlot (slot, 0);
+	}
+}
+
+//------------------------------------------------------------------------
+int32 ParameterBank::getNextChangeOffset (int32 numSamples) const
+{
+	auto nextOffset = numSamples;
+	forEachChanged ([&] (uint32 slot) { nextOffset = std::min (nextOffset, pointOffsets[slot]); });
+	return nextOffset;
+}
+
+//------------------------------------------------------------------------
+void ParameterBank::advance (int32 numSamples)
+{
+	auto targetOffset = position + numSamples;
+	forEachChanged ([&] (uint32 slot) { advanceSlot (slot, targetOffset); });
+	position = targetOffset;
+}
+
+//------------------------------------------------------------------------
+void ParameterBank::endChanges ()
+{
+	forEachChanged ([this] (uint32 slot) {
+		auto queue = queues[slot];
+		int32 sampleOffset;
+		ParamValue value;
+		if (queue->getPoint (queue->getPointCount () - 1, sampleOffset, value) == kResultTrue)
+			values[slot] = value;
+		queues[slot] = nullptr;
+		deltas[slot] = 0.;
+		pointOffsets[slot] = kNoPoint;
+	});
+	std::fill (changedSlots.begin (), changedSlots.end (), 0);
+	position = 0;
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
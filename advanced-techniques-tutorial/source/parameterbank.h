@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/vst/ivstparameterchanges.h"
+#include <limits>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+/** Sample accurate state of many parameters.
+ *
+ *	Like SampleAccurate::Parameter every parameter ramps linearly between the points of its
+ *	IParamValueQueue. The state is stored as a structure of arrays indexed by a slot number. Queues
+ *	are routed to their slot with a hash table in O(1) and the slots which received changes in the
+ *	current block are kept in a bitset, so that advance and endChanges only touch these.
+ *
+ *	Add all parameters before processing starts, addParameter allocates.
+ */
+class ParameterBank
+{
+public:
+	static constexpr uint32 kInvalidSlot = std::numeric_limits<uint32>::max ();
+
+	uint32 addParameter (Vst::ParamID paramID, Vst::ParamValue initValue = 0.);
+	uint32 getSlot (Vst::ParamID paramID) const;
+	uint32 getNumParameters () const { return static_cast<uint32> (paramIDs.size ()); }
+
+	Vst::ParamID getParamID (uint32 slot) const { return paramIDs[slot]; }
+	Vst::ParamValue getValue (uint32 slot) const { return values[slot]; }
+	void setValue (uint32 slot, Vst::ParamValue value) { values[slot] = value; }
+	bool hasChanges (uint32 slot) const;
+
+	/** Routes the queues of the block to their parameters. Unknown parameter IDs are ignored. */
+	void beginChanges (Vst::IParameterChanges* changes);
+	/** Returns the sample offset of the next automation point of any changed parameter after the
+	 *	current position, or numSamples if there is none before the end of the block. */
+	int32 getNextChangeOffset (int32 numSamples) const;
+	/** Advances all changed parameters by numSamples. */
+	void advance (int32 numSamples);
+	/** Sets all changed parameters to the value of their last point and clears the changes. */
+	void endChanges ();
+
+	/** Calls proc (slot) for every parameter which has changes in the current block. */
+	template <typename Proc>
+	void forEachChanged (Proc proc) const;
+
+//------------------------------------------------------------------------
+private:
+	static constexpr int32 kNoPoint = std::numeric_limits<int32>::max ();
+
+	static uint32 countTrailingZeros (uint64 word)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64 (&index, word);
+		return index;
+#else
+		return static_cast<uint32> (__builtin_ctzll (word));
+#endif
+	}
+
+	void rebuildLookup ();
+	void loadNextPoint (uint32 slot, int32 fromOffset);
+	void advanceSlot (uint32 slot, int32 targetOffset);
+
+	// parameter state, one entry per slot
+	std::vector<Vst::ParamID> paramIDs;
+	std::vector<Vst::ParamValue> values;
+	std::vector<Vst::ParamValue> deltas;
+	std::vector<Vst::ParamValue> pointValues;
+	std::vector<int32> pointOffsets;
+	std::vector<int32> pointIndices;
+	std::vector<Vst::IParamValueQueue*> queues;
+
+	// one bit per slot
+	std::vector<uint64> changedSlots;
+
+	// open addressing hash table from parameter ID to slot
+	std::vector<Vst::ParamID> lookupIDs;
+	std::vector<uint32> lookupSlots;
+	uint32 lookupMask {0};
+
+	int32 position {0};
+};
+
+//------------------------------------------------------------------------
+template <typename Proc>
+inline void ParameterBank::forEachChanged (Proc proc) const
+{
+	for (auto wordIndex = 0u; wordIndex < changedSlots.size (); ++wordIndex)
+	{
+		auto word = changedSlots[wordIndex];
+		while (word)
+		{
+			proc (wordIndex * 64 + countTrailingZeros (word));
+			word &= word - 1;
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -2,17 +2,23 @@
 // Copyright(c) 2023 Steinberg Media Technologies.
 //------------------------------------------------------------------------
 
+#include "../../common/source/busprocessing.h"
+#include "../../common/source/rtsafetycheck.h"
 #include "cids.h"
+#include "gainkernel.h"
+#include "parameterbank.h"
 #include "pids.h"
+#include "stateformat.h"
+#include "statetransfer.h"
 #include "public.sdk/source/vst/utility/audiobuffers.h"
-#include "public.sdk/source/vst/utility/processdataslicer.h"
-#include "public.sdk/source/vst/utility/rttransfer.h"
-#include "public.sdk/source/vst/utility/sampleaccurate.h"
 #include "public.sdk/source/vst/vstaudioeffect.h"
-#include "base/source/fstreamer.h"
+#include "base/source/fdebug.h"
 #include <array>
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <limits>
+#include <type_traits>
 #include <vector>
 
 //------------------------------------------------------------------------
@@ -27,10 +33,16 @@ struct StateModel
 };
 
 //------------------------------------------------------------------------
-struct MyEffect : public AudioEffect
+struct SliceStatistics
 {
-	using RTTransfer = RTTransferT<StateModel>;
+	uint32 lastBlockSlices {0};
+	uint64 numBlocks {0};
+	uint64 numSlices {0};
+};
 
+//------------------------------------------------------------------------
+struct MyEffect : public AudioEffect
+{
 	MyEffect ();
 	tresult PLUGIN_API initialize (FUnknown* context) SMTG_OVERRIDE;
 	tresult PLUGIN_API terminate () SMTG_OVERRIDE;
@@ -40,21 +52,42 @@ struct MyEffect : public AudioEffect
 	                                       SpeakerArrangement* outputs,
 	                                       int32 numOuts) SMTG_OVERRIDE;
 	tresult PLUGIN_API canProcessSampleSize (int32 symbolicSampleSize) SMTG_OVERRIDE;
+	tresult PLUGIN_API setActive (TBool state) SMTG_OVERRIDE;
 	tresult PLUGIN_API process (ProcessData& data) SMTG_OVERRIDE;
+	uint32 PLUGIN_API getTailSamples () SMTG_OVERRIDE;
 
 	void handleParameterChanges (IParameterChanges* changes);
 
 	template <SymbolicSampleSizes SampleSize>
 	void process (ProcessData& data);
-
-	SampleAccurate::Parameter gainParameter {ParameterID::Gain, 1.};
-	RTTransfer stateTransfer;
+	template <SymbolicSampleSizes SampleSize>
+	uint64 detectSilence (ProcessData& data);
+
+	/** Input channels with all samples below the linear threshold are treated as silent. Call
+	 *	it only while the processor is inactive, process reads the threshold without a lock. */
+	void setSilenceThreshold (double threshold) { silenceThreshold = threshold; }
+
+	// -120 dBFS
+	static constexpr double kDefaultSilenceThreshold = 1e-6;
+	// a speaker arrangement has at most 64 channels
+	static constexpr int32 kMaxChannels = 64;
+	double silenceThreshold {kDefaultSilenceThreshold};
+
+	ParameterBank parameters;
+	uint32 gainSlot {parameters.addParameter (ParameterID::Gain, 1.)};
+	// preallocated, setState does not allocate
+	StateTransfer<StateModel> stateTransfer;
+	// reserved for kMaxStateParameters, shared by setState and getState
+	std::vector<StateParameter> stateParameters;
+	// only written in process, read it when the processing is stopped
+	SliceStatistics sliceStatistics;
 };
 
 //------------------------------------------------------------------------
 MyEffect::MyEffect ()
 {
 	setControllerClass (ControllerUID);
+	stateParameters.reserve (kMaxStateParameters);
 }
 
 //------------------------------------------------------------------------
@@ -82,22 +115,19 @@ tresult PLUGIN_API MyEffect::setState (IBStream* state)
 	if (!state)
 		return kInvalidArgument;
 
-	IBStreamer streamer (state, kLittleEndian);
-
-	uint32 numParams;
-	if (streamer.readInt32u (numParams) == false)
-		return kResultFalse;
-
-	auto model = std::make_unique<StateModel> ();
-
-	ParamValue value;
-	if (!streamer.readDouble (value))
+	if (readState (state, stateParameters) != kResultTrue)
 		return kResultFalse;
 
-	model->gain = value;
+	StateModel newModel {1.};
+	for (const auto& parameter : stateParameters)
+	{
+		if (parameter.id == ParameterID::Gain)
+			newModel.gain = parameter.value;
+	}
 
-	stateTransfer.transferObject_ui (std::move (model));
-	return kResultTrue;
+	auto transferred =
+	    stateTransfer.transferObject_ui ([&] (StateModel& model) { model = newModel; });
+	return transferred ? kResultTrue : kResultFalse;
 }
 
 //------------------------------------------------------------------------
@@ -106,9 +136,11 @@ tresult PLUGIN_API MyEffect::getState (IBStream* state)
 	if (!state)
 		return kInvalidArgument;
 
-	IBStreamer streamer (state, kLittleEndian);
-	streamer.writeDouble (gainParameter.getValue ());
-	return kResultTrue;
+	stateParameters.resize (parameters.getNumParameters ());
+	for (auto slot = 0u; slot < parameters.getNumParameters (); ++slot)
+		stateParameters[slot] = {parameters.getParamID (slot), 0, parameters.getValue (slot)};
+	return writeState (state, stateParameters.data (),
+	                   static_cast<uint32> (stateParameters.size ()));
 }
 
 //------------------------------------------------------------------------
@@ -117,7 +149,8 @@ tresult PLUGIN_API MyEffect::setBusArrangements (SpeakerArrangement* inputs, int
 {
 	if (numIns != 1 || numOuts != 1)
 		return kResultFalse;
-	if (SpeakerArr::getChannelCount (inputs[0]) == SpeakerArr::getChannelCount (outputs[0]))
+	auto numChannels = SpeakerArr::getChannelCount (inputs[0]);
+	if (numChannels <= kMaxChannels && numChannels == SpeakerArr::getChannelCount (outputs[0]))
 	{
 		getAudioInput (0)->setArrangement (inputs[0]);
 		getAudioOutput (0)->setArrangement (outputs[0]);
@@ -135,58 +168,153 @@ tresult PLUGIN_API MyEffect::canProcessSampleSize (int32 symbolicSampleSize)
 	           kResultFalse;
 }
 
+//------------------------------------------------------------------------
+tresult PLUGIN_API MyEffect::setActive (TBool state)
+{
+	if (state)
+	{
+		beginRTViolationReport ();
+		sliceStatistics = {};
+	}
+	else
+	{
+		if (sliceStatistics.numBlocks > 0)
+		{
+			FDebugPrint ("Processed %llu blocks in %llu slices (%.2f slices per block)\n",
+			             static_cast<unsigned long long> (sliceStatistics.numBlocks),
+			             static_cast<unsigned long long> (sliceStatistics.numSlices),
+			             static_cast<double> (sliceStatistics.numSlices) /
+			                 sliceStatistics.numBlocks);
+		}
+		auto transferStatistics = stateTransfer.getStatistics ();
+		if (transferStatistics.numCoalesced > 0 || transferStatistics.numDropped > 0)
+		{
+			FDebugPrint ("State transfers: %llu received, %llu coalesced, %llu dropped\n",
+			             static_cast<unsigned long long> (transferStatistics.numTransfers),
+			             static_cast<unsigned long long> (transferStatistics.numCoalesced),
+			             static_cast<unsigned long long> (transferStatistics.numDropped));
+		}
+		reportRTViolations ("MyEffect");
+	}
+	return AudioEffect::setActive (state);
+}
+
 //------------------------------------------------------------------------
 template <SymbolicSampleSizes SampleSize>
 void MyEffect::process (ProcessData& data)
 {
-	ProcessDataSlicer slicer (8);
+	if (data.numSamples <= 0)
+		return;
 
-	auto doProcessing = [this] (ProcessData& data) {
-		// get the gain value for this block
-		ParamValue gain = gainParameter.advance (data.numSamples);
+	AudioBusBuffers* inputs = data.inputs;
+	AudioBusBuffers* outputs = data.outputs;
+	auto inputBuffers = getChannelBuffers<SampleSize> (inputs[0]);
+	auto outputBuffers = getChannelBuffers<SampleSize> (outputs[0]);
+	auto numChannels = inputs[0].numChannels;
+
+	// a silent input stays silent whatever the gain is, so silent channels are neither processed
+	// nor copied
+	auto silenceFlags = detectSilence<SampleSize> (data);
+	outputs[0].silenceFlags = silenceFlags;
+	if (silenceFlags == getSilenceMask (numChannels) && numChannels <= 64)
+		return;
 
-		// process audio
-		AudioBusBuffers* inputs = data.inputs;
-		AudioBusBuffers* outputs = data.outputs;
-		for (auto channelIndex = 0; channelIndex < inputs[0].numChannels; ++channelIndex)
-		{
-			auto inputBuffers = getChannelBuffers<SampleSize> (inputs[0])[channelIndex];
-			auto outputBuffers = getChannelBuffers<SampleSize> (outputs[0])[channelIndex];
-			for (auto sampleIndex = 0; sampleIndex < data.numSamples; ++sampleIndex)
-			{
-				auto sample = inputBuffers[sampleIndex];
-				outputBuffers[sampleIndex] = sample * gain;
-			}
-		}
+	// gather the audible channels once per block, the kernel processes several of them per pass
+	using SampleType = std::remove_pointer_t<std::remove_pointer_t<decltype (inputBuffers)>>;
+	std::array<const SampleType*, kMaxChannels> activeInputs;
+	std::array<SampleType*, kMaxChannels> activeOutputs;
+	int32 numActiveChannels = 0;
+	for (auto channelIndex = 0; channelIndex < std::min (numChannels, kMaxChannels); ++channelIndex)
+	{
+		if (isChannelSilent (silenceFlags, channelIndex))
+			continue;
+		activeInputs[numActiveChannels] = inputBuffers[channelIndex];
+		activeOutputs[numActiveChannels] = outputBuffers[channelIndex];
+		++numActiveChannels;
+	}
+
+	uint32 numSlices = 0;
+	int32 sliceStart = 0;
+	auto processSlice = [&] (int32 sliceEnd) {
+		auto numSamples = sliceEnd - sliceStart;
+
+		// the gain ramps linearly from its value at the start to its value at the end of the slice
+		ParamValue gainStart = parameters.getValue (gainSlot);
+		parameters.advance (numSamples);
+		ParamValue gainEnd = parameters.getValue (gainSlot);
+		ParamValue gainIncrement = (gainEnd - gainStart) / numSamples;
+
+		// process audio, input and output may be the same buffer
+		applyGainRamp (activeInputs.data (), activeOutputs.data (), numActiveChannels, sliceStart,
+		               numSamples, gainStart, gainIncrement);
+		sliceStart = sliceEnd;
+		++numSlices;
 	};
 
-	slicer.process<SampleSize> (data, doProcessing);
+	// the parameters ramp linearly between their automation points, so the block only needs to be
+	// sliced at the offsets of the points. Without automation the whole block is one slice.
+	while (sliceStart < data.numSamples)
+		processSlice (parameters.getNextChangeOffset (data.numSamples));
+
+	sliceStatistics.lastBlockSlices = numSlices;
+	sliceStatistics.numSlices += numSlices;
+	++sliceStatistics.numBlocks;
 }
 
 //------------------------------------------------------------------------
-void MyEffect::handleParameterChanges (IParameterChanges* changes)
+template <SymbolicSampleSizes SampleSize>
+uint64 MyEffect::detectSilence (ProcessData& data)
 {
-	if (!changes)
-		return;
-	int32 changeCount = changes->getParameterCount ();
-	for (auto i = 0; i < changeCount; ++i)
+	auto& input = data.inputs[0];
+	auto& output = data.outputs[0];
+	auto inputBuffers = getChannelBuffers<SampleSize> (input);
+	auto outputBuffers = getChannelBuffers<SampleSize> (output);
+	auto numChannels = input.numChannels;
+	auto numSamples = data.numSamples;
+	auto mask = getSilenceMask (numChannels);
+	auto silenceFlags = input.silenceFlags & mask;
+
+	// a gain of zero for the whole block silences all channels
+	if (!parameters.hasChanges (gainSlot) && parameters.getValue (gainSlot) == 0.)
+		silenceFlags = mask;
+
+	using SampleType = std::remove_pointer_t<std::remove_pointer_t<decltype (inputBuffers)>>;
+	auto threshold = static_cast<SampleType> (silenceThreshold);
+	auto numFlaggedChannels = std::min (numChannels, 64);
+	for (auto channelIndex = 0; channelIndex < numFlaggedChannels; ++channelIndex)
 	{
-		if (auto queue = changes->getParameterData (i))
+		if (isChannelSilent (input.silenceFlags, channelIndex))
 		{
-			auto paramID = queue->getParameterId ();
-			if (paramID == ParameterID::Gain)
-			{
-				gainParameter.beginChanges (queue);
-			}
+			// silent input from the host, the output only needs clearing if it is another buffer
+			silenceOutputChannel (inputBuffers[channelIndex], outputBuffers[channelIndex],
+			                      numSamples);
+		}
+		else if (isChannelSilent (silenceFlags, channelIndex) ||
+		         isBufferSilent (inputBuffers[channelIndex], numSamples, threshold))
+		{
+			// the output has to contain zeros when the flag is set, also in place
+			std::memset (outputBuffers[channelIndex], 0, numSamples * sizeof (SampleType));
+			silenceFlags |= uint64 {1} << channelIndex;
 		}
 	}
+	return silenceFlags;
+}
+
+//------------------------------------------------------------------------
+void MyEffect::handleParameterChanges (IParameterChanges* changes)
+{
+	// the queues are routed to their parameter by a table lookup, independent of the number of
+	// parameters
+	parameters.beginChanges (changes);
 }
 
 //------------------------------------------------------------------------
 tresult PLUGIN_API MyEffect::process (ProcessData& data)
 {
+	[[maybe_unused]] RTSafetyCheckScope rtSafetyCheck;
+
 	stateTransfer.accessTransferObject_rt (
-	    [this] (const auto& stateModel) { gainParameter.setValue (stateModel.gain); });
+	    [this] (const auto& stateModel) { parameters.setValue (gainSlot, stateModel.gain); });
 
 	handleParameterChanges (data.inputParameterChanges);
 
@@ -195,10 +323,17 @@ tresult PLUGIN_API MyEffect::process (ProcessData& data)
 	else
 		process<SymbolicSampleSizes::kSample64> (data);
 
-	gainParameter.endChanges ();
+	parameters.endChanges ();
 	return kResultTrue;
 }
 
+//------------------------------------------------------------------------
+uint32 PLUGIN_API MyEffect::getTailSamples ()
+{
+	// the gain does not add a tail, the host may stop processing as soon as the input is silent
+	return kNoTail;
+}
+
 //------------------------------------------------------------------------
 FUnknown* createProcessorInstance (void*)
 {
@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "stateformat.h"
+#include "pids.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+#if BYTEORDER == kBigEndian
+constexpr bool kSwapBytes = true;
+#else
+constexpr bool kSwapBytes = false;
+#endif
+
+//------------------------------------------------------------------------
+template <typename T>
+void swapBytes (T& value)
+{
+	auto bytes = reinterpret_cast<uint8*> (&value);
+	std::reverse (bytes, bytes + sizeof (T));
+}
+
+//------------------------------------------------------------------------
+void swapBytes (StateHeader& header)
+{
+	swapBytes (header.magic);
+	swapBytes (header.version);
+	swapBytes (header.headerSize);
+	swapBytes (header.numParameters);
+	swapBytes (header.checksum);
+}
+
+//------------------------------------------------------------------------
+void swapBytes (StateParameter& parameter)
+{
+	swapBytes (parameter.id);
+	swapBytes (parameter.reserved);
+	swapBytes (parameter.value);
+}
+
+//------------------------------------------------------------------------
+uint32 calculateChecksum (const void* data, uint32 numBytes)
+{
+	// FNV-1a
+	uint32 hash = 2166136261u;
+	auto bytes = static_cast<const uint8*> (data);
+	for (auto index = 0u; index < numBytes; ++index)
+	{
+		hash ^= bytes[index];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+//------------------------------------------------------------------------
+tresult readLegacyState (const uint8* data, int32 numBytes, std::vector<StateParameter>& parameters)
+{
+	// first versions of the tutorial wrote the gain only, some read a parameter count before it
+	int32 valueOffset;
+	if (numBytes == sizeof (Vst::ParamValue))
+		valueOffset = 0;
+	else if (numBytes == sizeof (uint32) + sizeof (Vst::ParamValue))
+		valueOffset = sizeof (uint32);
+	else
+		return kResultFalse;
+
+	StateParameter gain {ParameterID::Gain, 0, 0.};
+	std::memcpy (&gain.value, data + valueOffset, sizeof (gain.value));
+	if (kSwapBytes)
+		swapBytes (gain.value);
+	parameters.assign (1, gain);
+	return kResultTrue;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+tresult writeState (IBStream* stream, const StateParameter* parameters, uint32 numParameters)
+{
+	if (!stream)
+		return kInvalidArgument;
+
+	std::vector<StateParameter> swapped;
+	if (kSwapBytes)
+	{
+		swapped.assign (parameters, parameters + numParameters);
+		for (auto& parameter : swapped)
+			swapBytes (parameter);
+		parameters = swapped.data ();
+	}
+
+	auto arraySize = static_cast<int32> (numParameters * sizeof (StateParameter));
+	StateHeader header {kStateMagic, kStateVersion, sizeof (StateHeader), numParameters,
+	                    calculateChecksum (parameters, arraySize)};
+	if (kSwapBytes)
+		swapBytes (header);
+
+	int32 numBytesWritten = 0;
+	if (stream->write (&header, sizeof (header), &numBytesWritten) != kResultTrue ||
+	    numBytesWritten != sizeof (header))
+		return kResultFalse;
+	if (arraySize == 0)
+		return kResultTrue;
+	if (stream->write (const_cast<StateParameter*> (parameters), arraySize, &numBytesWritten) !=
+	        kResultTrue ||
+	    numBytesWritten != arraySize)
+		return kResultFalse;
+	return kResultTrue;
+}
+
+//------------------------------------------------------------------------
+tresult readState (IBStream* stream, std::vector<StateParameter>& parameters)
+{
+	if (!stream)
+		return kInvalidArgument;
+
+	StateHeader header {};
+	int32 numBytesRead = 0;
+	if (stream->read (&header, sizeof (header), &numBytesRead) != kResultTrue)
+		return kResultFalse;
+	if (kSwapBytes)
+		swapBytes (header);
+
+	if (numBytesRead < static_cast<int32> (sizeof (header)) || header.magic != kStateMagic)
+	{
+		if (kSwapBytes)
+			swapBytes (header);
+		return readLegacyState (reinterpret_cast<const uint8*> (&header), numBytesRead,
+		                        parameters);
+	}
+
+	if (header.version == 0 || header.headerSize < sizeof (StateHeader))
+		return kResultFalse;
+	if (header.headerSize > sizeof (StateHeader))
+	{
+		int64 position;
+		if (stream->seek (header.headerSize - sizeof (StateHeader), IBStream::kIBSeekCur,
+		                  &position) != kResultTrue)
+			return kResultFalse;
+	}
+
+	// the count comes from the stream, bound it before it sizes anything
+	if (header.numParameters > kMaxStateParameters)
+		return kResultFalse;
+	auto arraySize64 = uint64 {header.numParameters} * sizeof (StateParameter);
+	if (arraySize64 > static_cast<uint64> (std::numeric_limits<int32>::max ()))
+		return kResultFalse;
+	auto arraySize = static_cast<int32> (arraySize64);
+	parameters.resize (header.numParameters);
+	if (arraySize > 0)
+	{
+		if (stream->read (parameters.data (), arraySize, &numBytesRead) != kResultTrue ||
+		    numBytesRead != arraySize)
+			return kResultFalse;
+	}
+	if (calculateChecksum (parameters.data (), arraySize) != header.checksum)
+		return kResultFalse;
+
+	if (kSwapBytes)
+	{
+		for (auto& parameter : parameters)
+			swapBytes (parameter);
+	}
+	return kResultTrue;
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/base/ibstream.h"
+#include "pluginterfaces/vst/vsttypes.h"
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+/** The state shared by the processor and the controller.
+ *
+ *	All values are little endian:
+ *
+ *	StateHeader        magic, version, header size, parameter count and a checksum of the array
+ *	StateParameter[]   one entry per parameter, read and written with a single stream call
+ *
+ *	Newer versions may append fields to the header, readers skip them via headerSize. States written
+ *	before this format (a single gain double, optionally preceded by a parameter count) are still
+ *	read.
+ */
+static constexpr uint32 kStateMagic = 0x54534754; // 'TGST'
+static constexpr uint16 kStateVersion = 1;
+// states with more parameters are rejected as corrupt, reserve this many to read without allocating
+static constexpr uint32 kMaxStateParameters = 1024;
+
+//------------------------------------------------------------------------
+struct StateHeader
+{
+	uint32 magic;
+	uint16 version;
+	uint16 headerSize;
+	uint32 numParameters;
+	uint32 checksum;
+};
+
+//------------------------------------------------------------------------
+struct StateParameter
+{
+	Vst::ParamID id;
+	uint32 reserved;
+	Vst::ParamValue value;
+};
+
+static_assert (sizeof (StateHeader) == 16, "StateHeader must be packed");
+static_assert (sizeof (StateParameter) == 16, "StateParameter must be packed");
+
+//------------------------------------------------------------------------
+/** Writes the header and the parameter array. */
+tresult writeState (IBStream* stream, const StateParameter* parameters, uint32 numParameters);
+
+//------------------------------------------------------------------------
+/** Reads a state written by writeState or by an older version of the plug-in.
+ *
+ *	parameters is resized to the number of stored parameters; reuse it with a capacity of
+ *	kMaxStateParameters to avoid allocations. Returns kResultFalse if the state is truncated, holds
+ *	more than kMaxStateParameters parameters or the checksum does not match. */
+tresult readState (IBStream* stream, std::vector<StateParameter>& parameters);
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/base/ftypes.h"
+#include <array>
+#include <atomic>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+struct StateTransferStatistics
+{
+	/** transfers the realtime thread has received */
+	uint64 numTransfers {0};
+	/** transfers replaced by a newer one before the realtime thread received them */
+	uint64 numCoalesced {0};
+	/** transfers rejected because no slot was free */
+	uint64 numDropped {0};
+};
+
+//------------------------------------------------------------------------
+/** Transfers an object from any number of non realtime threads to the realtime thread.
+ *
+ *	In contrast to RTTransferT the objects live in a pool of NumSlots slots which is allocated with
+ *	the transfer itself, so a transfer does not allocate nor free memory. A producer fills a free slot
+ *	in place and publishes it. If the realtime thread has not yet received the previously published
+ *	slot it is recycled, only the newest object is delivered. One slot is owned by the realtime
+ *	thread, one may be pending and the others are free for producers, so with three slots a single
+ *	producer always finds a free one. Add more slots for more concurrent producers.
+ *
+ *	The realtime side is wait-free: one atomic exchange and one atomic store.
+ */
+template <typename ObjectT, uint32 NumSlots = 3>
+class StateTransfer
+{
+public:
+	static_assert (NumSlots >= 3, "need one live, one pending and one free slot");
+
+	using ObjectType = ObjectT;
+
+	/** Fills a free slot with proc (ObjectT&) and publishes it to the realtime thread.
+	 *
+	 *	The slot contains the object of an earlier transfer, proc has to set all of it. Returns false
+	 *	if there was no free slot. */
+	template <typename Proc>
+	bool transferObject_ui (Proc proc)
+	{
+		auto slotIndex = acquireFreeSlot ();
+		if (slotIndex == kNoSlot)
+		{
+			numDropped.fetch_add (1, std::memory_order_relaxed);
+			return false;
+		}
+		proc (slots[slotIndex].object);
+		slots[slotIndex].state.store (SlotState::Pending, std::memory_order_release);
+
+		auto previous = pending.exchange (slotIndex, std::memory_order_acq_rel);
+		if (previous != kNoSlot)
+		{
+			slots[previous].state.store (SlotState::Free, std::memory_order_release);
+			numCoalesced.fetch_add (1, std::memory_order_relaxed);
+		}
+		return true;
+	}
+
+	/** Calls proc (const ObjectT&) on the realtime thread if a new object was transferred. */
+	template <typename Proc>
+	void accessTransferObject_rt (Proc proc)
+	{
+		auto slotIndex = pending.exchange (kNoSlot, std::memory_order_acq_rel);
+		if (slotIndex == kNoSlot)
+			return;
+		if (live != kNoSlot)
+			slots[live].state.store (SlotState::Free, std::memory_order_release);
+		live = slotIndex;
+		slots[live].state.store (SlotState::Live, std::memory_order_relaxed);
+		numTransfers.fetch_add (1, std::memory_order_relaxed);
+		proc (static_cast<const ObjectT&> (slots[live].object));
+	}
+
+	/** Frees all slots. Only call this when the realtime thread does not access the transfer. */
+	void clear_ui ()
+	{
+		pending.store (kNoSlot, std::memory_order_relaxed);
+		live = kNoSlot;
+		for (auto& slot : slots)
+			slot.state.store (SlotState::Free, std::memory_order_release);
+	}
+
+	StateTransferStatistics getStatistics () const
+	{
+		StateTransferStatistics statistics;
+		statistics.numTransfers = numTransfers.load (std::memory_order_relaxed);
+		statistics.numCoalesced = numCoalesced.load (std::memory_order_relaxed);
+		statistics.numDropped = numDropped.load (std::memory_order_relaxed);
+		return statistics;
+	}
+
+	void resetStatistics ()
+	{
+		numTransfers.store (0, std::memory_order_relaxed);
+		numCoalesced.store (0, std::memory_order_relaxed);
+		numDropped.store (0, std::memory_order_relaxed);
+	}
+
+//------------------------------------------------------------------------
+private:
+	static constexpr uint32 kNoSlot = NumSlots;
+
+	enum class SlotState : uint32
+	{
+		Free,
+		Writing,
+		Pending,
+		Live,
+	};
+
+	struct alignas (64) Slot
+	{
+		std::atomic<SlotState> state {SlotState::Free};
+		ObjectT object {};
+	};
+
+	uint32 acquireFreeSlot ()
+	{
+		for (auto slotIndex = 0u; slotIndex < NumSlots; ++slotIndex)
+		{
+			auto expected = SlotState::Free;
+			if (slots[slotIndex].state.compare_exchange_strong (expected, SlotState::Writing,
+			                                                    std::memory_order_acquire))
+				return slotIndex;
+		}
+		return kNoSlot;
+	}
+
+	std::array<Slot, NumSlots> slots;
+	std::atomic<uint32> pending {kNoSlot};
+	// only accessed by the realtime thread
+	uint32 live {kNoSlot};
+
+	std::atomic<uint64> numTransfers {0};
+	std::atomic<uint64> numCoalesced {0};
+	std::atomic<uint64> numDropped {0};
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
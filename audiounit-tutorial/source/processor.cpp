@@ -4,6 +4,8 @@
 
 #include "processor.h"
 #include "cids.h"
+#include "../../common/source/busprocessing.h"
+#include "../../common/source/rtsafetycheck.h"
 
 #include "base/source/fstreamer.h"
 #include "pluginterfaces/vst/ivstparameterchanges.h"
@@ -60,12 +62,19 @@ tresult PLUGIN_API VST3AUPlugInProcessor::terminate ()
 tresult PLUGIN_API VST3AUPlugInProcessor::setActive (TBool state)
 {
 	//--- called when the Plug-in is enable/disable (On/Off) -----
+	if (state)
+		Tutorial::beginRTViolationReport ();
+	else
+		Tutorial::reportRTViolations ("VST3AUPlugInProcessor");
 	return AudioEffect::setActive (state);
 }
 
 //------------------------------------------------------------------------
 tresult PLUGIN_API VST3AUPlugInProcessor::process (Vst::ProcessData& data)
 {
+	//--- only active when built with the realtime safety check -----
+	[[maybe_unused]] Tutorial::RTSafetyCheckScope rtSafetyCheck;
+
 	//--- First : Read inputs parameter changes-----------
 
 	/*if (data.inputParameterChanges)
@@ -98,16 +107,10 @@ tresult PLUGIN_API VST3AUPlugInProcessor::process (Vst::ProcessData& data)
 		for (int32 i = 0; i < minBus; i++)
 		{
 			int32 minChan = std::min (data.inputs[i].numChannels, data.outputs[i].numChannels);
-			for (int32 c = 0; c < minChan; c++)
-			{
-				// do not need to be copied if the buffers are the same
-				if (data.outputs[i].channelBuffers32[c] != data.inputs[i].channelBuffers32[c])
-				{
-					memcpy (data.outputs[i].channelBuffers32[c], data.inputs[i].channelBuffers32[c],
-							data.numSamples * sizeof (Vst::Sample32));
-				}
-			}
-			data.outputs[i].silenceFlags = data.inputs[i].silenceFlags;
+			// buffers processed in place are not copied and silent inputs are cleared instead
+			data.outputs[i].silenceFlags = Tutorial::passThroughChannels (
+			    data.inputs[i].channelBuffers32, data.outputs[i].channelBuffers32, minChan,
+			    data.numSamples, data.inputs[i].silenceFlags);
 				
 			// clear the remaining output buffers
 			for (int32 c = minChan; c < data.outputs[i].numChannels; c++)
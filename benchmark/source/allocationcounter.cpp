@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "allocationcounter.h"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+thread_local bool countAllocations = false;
+thread_local AllocationCount allocationCount;
+
+//------------------------------------------------------------------------
+void* allocate (std::size_t size, std::size_t alignment = 0)
+{
+	if (countAllocations)
+	{
+		++allocationCount.numAllocations;
+		allocationCount.numBytes += size;
+	}
+	if (size == 0)
+		size = 1;
+	void* ptr = nullptr;
+	if (alignment > alignof (std::max_align_t))
+	{
+#if defined(_MSC_VER)
+		ptr = _aligned_malloc (size, alignment);
+#else
+		if (posix_memalign (&ptr, alignment, size) != 0)
+			ptr = nullptr;
+#endif
+	}
+	else
+	{
+		ptr = std::malloc (size);
+	}
+	return ptr;
+}
+
+//------------------------------------------------------------------------
+void deallocate (void* ptr, bool aligned = false) noexcept
+{
+	if (!ptr)
+		return;
+	if (countAllocations)
+		++allocationCount.numDeallocations;
+#if defined(_MSC_VER)
+	if (aligned)
+	{
+		_aligned_free (ptr);
+		return;
+	}
+#endif
+	(void)aligned;
+	std::free (ptr);
+}
+
+//------------------------------------------------------------------------
+void* allocateOrThrow (std::size_t size, std::size_t alignment = 0)
+{
+	if (auto ptr = allocate (size, alignment))
+		return ptr;
+	throw std::bad_alloc ();
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+AllocationCountScope::AllocationCountScope ()
+{
+	countAllocations = true;
+}
+
+//------------------------------------------------------------------------
+AllocationCountScope::~AllocationCountScope () noexcept
+{
+	countAllocations = false;
+}
+
+//------------------------------------------------------------------------
+AllocationCount getAllocationCount ()
+{
+	return allocationCount;
+}
+
+//------------------------------------------------------------------------
+void resetAllocationCount ()
+{
+	allocationCount = {};
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
+
+using Steinberg::Tutorial::allocateOrThrow;
+using Steinberg::Tutorial::allocate;
+using Steinberg::Tutorial::deallocate;
+
+//------------------------------------------------------------------------
+// Replacements of the global allocation functions
+//------------------------------------------------------------------------
+void* operator new (std::size_t size)
+{
+	return allocateOrThrow (size);
+}
+void* operator new[] (std::size_t size)
+{
+	return allocateOrThrow (size);
+}
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate (size);
+}
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate (size);
+}
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+	return allocateOrThrow (size, static_cast<std::size_t> (alignment));
+}
+void* operator new[] (std::size_t size, std::align_val_t alignment)
+{
+	return allocateOrThrow (size, static_cast<std::size_t> (alignment));
+}
+void operator delete (void* ptr) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete[] (void* ptr) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete (void* ptr, std::size_t) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete[] (void* ptr, std::size_t) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete (void* ptr, std::align_val_t) noexcept
+{
+	deallocate (ptr, true);
+}
+void operator delete[] (void* ptr, std::align_val_t) noexcept
+{
+	deallocate (ptr, true);
+}
+void operator delete (void* ptr, std::size_t, std::align_val_t) noexcept
+{
+	deallocate (ptr, true);
+}
+void operator delete[] (void* ptr, std::size_t, std::align_val_t) noexcept
+{
+	deallocate (ptr, true);
+}
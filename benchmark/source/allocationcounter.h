@@ -0,0 +1,38 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/base/ftypes.h"
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+/** Counts the calls to the global operator new and delete of the calling thread.
+ *
+ *	Only the allocations of the thread which created the scope are counted and only as long as the
+ *	scope exists. Place one around a call to IAudioProcessor::process.
+ */
+struct AllocationCountScope
+{
+	AllocationCountScope ();
+	~AllocationCountScope () noexcept;
+};
+
+//------------------------------------------------------------------------
+struct AllocationCount
+{
+	uint64 numAllocations {0};
+	uint64 numDeallocations {0};
+	uint64 numBytes {0};
+};
+
+//------------------------------------------------------------------------
+/** Returns the allocations counted on the calling thread. */
+AllocationCount getAllocationCount ();
+void resetAllocationCount ();
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
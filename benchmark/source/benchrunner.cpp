@@ -0,0 +1,263 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "benchrunner.h"
+#include "allocationcounter.h"
+#include "public.sdk/source/vst/hosting/parameterchanges.h"
+#include "pluginterfaces/vst/ivstaudioprocessor.h"
+#include "pluginterfaces/vst/ivstcomponent.h"
+#include "pluginterfaces/vst/ivstmessage.h"
+#include "pluginterfaces/vst/ivstprocesscontext.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+using namespace Steinberg::Vst;
+
+//------------------------------------------------------------------------
+namespace {
+
+// all tutorial plug-ins use 1 as the ID of their first parameter
+constexpr ParamID kAutomatedParamID = 1;
+constexpr int32 kAutomationPointsPerBlock = 4;
+constexpr double kAutomationFrequency = 0.5;
+constexpr double kSignalFrequency = 440.;
+
+//------------------------------------------------------------------------
+class NullConnectionPoint : public IConnectionPoint
+{
+public:
+	NullConnectionPoint () { FUNKNOWN_CTOR }
+	virtual ~NullConnectionPoint () { FUNKNOWN_DTOR }
+
+	tresult PLUGIN_API connect (IConnectionPoint*) override { return kResultTrue; }
+	tresult PLUGIN_API disconnect (IConnectionPoint*) override { return kResultTrue; }
+	tresult PLUGIN_API notify (IMessage*) override
+	{
+		++numMessages;
+		return kResultTrue;
+	}
+
+	uint64 numMessages {0};
+
+	DECLARE_FUNKNOWN_METHODS
+};
+
+IMPLEMENT_FUNKNOWN_METHODS (NullConnectionPoint, IConnectionPoint, IConnectionPoint::iid)
+
+//------------------------------------------------------------------------
+inline void setChannelBuffers (AudioBusBuffers& bus, Sample32** buffers)
+{
+	bus.channelBuffers32 = buffers;
+}
+
+//------------------------------------------------------------------------
+inline void setChannelBuffers (AudioBusBuffers& bus, Sample64** buffers)
+{
+	bus.channelBuffers64 = buffers;
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+struct BenchBuffers
+{
+	BenchBuffers (int32 numChannels, int32 numSamples, SampleRate sampleRate)
+	: inputData (numChannels, std::vector<SampleType> (numSamples))
+	, outputData (numChannels, std::vector<SampleType> (numSamples))
+	{
+		constexpr double twoPi = 6.283185307179586;
+		for (auto channel = 0; channel < numChannels; ++channel)
+		{
+			for (auto sample = 0; sample < numSamples; ++sample)
+			{
+				auto phase = twoPi * kSignalFrequency * (channel + 1) * sample / sampleRate;
+				inputData[channel][sample] = static_cast<SampleType> (0.5 * std::sin (phase));
+			}
+			inputs.push_back (inputData[channel].data ());
+			outputs.push_back (outputData[channel].data ());
+		}
+		inputBus.numChannels = numChannels;
+		outputBus.numChannels = numChannels;
+		setChannelBuffers (inputBus, inputs.data ());
+		setChannelBuffers (outputBus, outputs.data ());
+	}
+
+	std::vector<std::vector<SampleType>> inputData;
+	std::vector<std::vector<SampleType>> outputData;
+	std::vector<SampleType*> inputs;
+	std::vector<SampleType*> outputs;
+	AudioBusBuffers inputBus;
+	AudioBusBuffers outputBus;
+};
+
+//------------------------------------------------------------------------
+void addAutomation (ParameterChanges& changes, int64 blockStart, const BenchConfig& config)
+{
+	constexpr double twoPi = 6.283185307179586;
+	int32 index;
+	auto queue = changes.addParameterData (kAutomatedParamID, index);
+	if (!queue)
+		return;
+	for (auto point = 0; point < kAutomationPointsPerBlock; ++point)
+	{
+		auto offset = (config.blockSize * (point + 1)) / kAutomationPointsPerBlock - 1;
+		auto time = (blockStart + offset) / config.sampleRate;
+		auto value = 0.5 + 0.5 * std::sin (twoPi * kAutomationFrequency * time);
+		queue->addPoint (offset, value, index);
+	}
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void processBlocks (IAudioProcessor* processor, const BenchConfig& config, int32 numChannels,
+                    BenchResult& result)
+{
+	BenchBuffers<SampleType> buffers (numChannels, config.blockSize, config.sampleRate);
+	ParameterChanges inputParameterChanges (1);
+
+	ProcessContext processContext {};
+	processContext.state = ProcessContext::kPlaying | ProcessContext::kSystemTimeValid;
+	processContext.sampleRate = config.sampleRate;
+
+	ProcessData data;
+	data.processMode = kRealtime;
+	data.symbolicSampleSize = config.symbolicSampleSize;
+	data.numSamples = config.blockSize;
+	data.numInputs = 1;
+	data.numOutputs = 1;
+	data.inputs = &buffers.inputBus;
+	data.outputs = &buffers.outputBus;
+	data.inputParameterChanges = config.automation ? &inputParameterChanges : nullptr;
+	data.processContext = &processContext;
+
+	auto numBlocks = static_cast<int64> (
+	    std::ceil (config.secondsToProcess * config.sampleRate / config.blockSize));
+	std::vector<double> blockDurations;
+	blockDurations.reserve (numBlocks);
+
+	resetAllocationCount ();
+	auto totalDuration = 0.;
+	for (int64 block = 0; block < numBlocks; ++block)
+	{
+		auto blockStart = block * config.blockSize;
+		inputParameterChanges.clearQueue ();
+		if (config.automation)
+			addAutomation (inputParameterChanges, blockStart, config);
+		processContext.projectTimeSamples = blockStart;
+		processContext.continousTimeSamples = blockStart;
+
+		std::chrono::steady_clock::time_point start, end;
+		{
+			AllocationCountScope allocationScope;
+			start = std::chrono::steady_clock::now ();
+			processContext.systemTime = std::chrono::duration_cast<std::chrono::nanoseconds> (
+			                                start.time_since_epoch ())
+			                                .count ();
+			processor->process (data);
+			end = std::chrono::steady_clock::now ();
+		}
+		auto duration = std::chrono::duration<double, std::nano> (end - start).count ();
+		blockDurations.push_back (duration);
+		totalDuration += duration;
+	}
+	auto allocationCount = getAllocationCount ();
+
+	std::sort (blockDurations.begin (), blockDurations.end ());
+	auto percentile = [&] (double p) {
+		auto index = static_cast<size_t> (p * (blockDurations.size () - 1));
+		return blockDurations[index] / 1000.;
+	};
+	result.numBlocks = static_cast<uint64> (numBlocks);
+	result.nanosecondsPerSample = totalDuration / (static_cast<double> (numBlocks) * config.blockSize);
+	result.p50BlockMicroseconds = percentile (0.5);
+	result.p99BlockMicroseconds = percentile (0.99);
+	result.maxBlockMicroseconds = blockDurations.back () / 1000.;
+	result.numAllocations = allocationCount.numAllocations;
+	result.numDeallocations = allocationCount.numDeallocations;
+	result.numAllocatedBytes = allocationCount.numBytes;
+	result.valid = true;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+BenchResult runBenchmark (const BenchPlugin& plugin, const BenchConfig& config,
+                          FUnknown* hostContext)
+{
+	BenchResult result;
+	if (config.blockSize <= 0 || config.sampleRate <= 0.)
+	{
+		result.error = "invalid configuration";
+		return result;
+	}
+
+	auto unknown = plugin.createInstance (nullptr);
+	if (!unknown)
+	{
+		result.error = "the plug-in could not be created";
+		return result;
+	}
+	FUnknownPtr<IComponent> component (unknown);
+	FUnknownPtr<IAudioProcessor> processor (unknown);
+	FUnknownPtr<IConnectionPoint> connectionPoint (unknown);
+	unknown->release ();
+	if (!component || !processor)
+	{
+		result.error = "the plug-in is not an audio processor";
+		return result;
+	}
+	if (component->initialize (hostContext) != kResultOk)
+	{
+		result.error = "the plug-in could not be initialized";
+		return result;
+	}
+
+	auto peer = owned (new NullConnectionPoint);
+	if (connectionPoint)
+		connectionPoint->connect (peer);
+
+	auto arrangement = config.arrangement;
+	auto numChannels = SpeakerArr::getChannelCount (arrangement);
+	ProcessSetup setup {kRealtime, config.symbolicSampleSize, config.blockSize, config.sampleRate};
+	if (processor->setBusArrangements (&arrangement, 1, &arrangement, 1) != kResultTrue)
+	{
+		result.error = "speaker arrangement not supported";
+	}
+	else if (processor->canProcessSampleSize (config.symbolicSampleSize) != kResultTrue)
+	{
+		result.error = "sample size not supported";
+	}
+	else if (processor->setupProcessing (setup) != kResultOk)
+	{
+		result.error = "setupProcessing failed";
+	}
+	else if (component->setActive (true) != kResultOk)
+	{
+		result.error = "the plug-in could not be activated";
+	}
+	else
+	{
+		processor->setProcessing (true);
+		if (config.symbolicSampleSize == kSample64)
+			processBlocks<Sample64> (processor, config, numChannels, result);
+		else
+			processBlocks<Sample32> (processor, config, numChannels, result);
+		processor->setProcessing (false);
+		component->setActive (false);
+	}
+	result.numMessages = peer->numMessages;
+
+	if (connectionPoint)
+		connectionPoint->disconnect (peer);
+	component->terminate ();
+	return result;
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/base/funknown.h"
+#include "pluginterfaces/vst/vsttypes.h"
+#include <string>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+struct BenchPlugin
+{
+	const char* name;
+	FUnknown* (*createInstance) (void*);
+};
+
+//------------------------------------------------------------------------
+struct BenchConfig
+{
+	Vst::SampleRate sampleRate {48000.};
+	int32 blockSize {256};
+	Vst::SpeakerArrangement arrangement {0};
+	int32 symbolicSampleSize {0};
+	bool automation {false};
+	double secondsToProcess {10.};
+};
+
+//------------------------------------------------------------------------
+struct BenchResult
+{
+	bool valid {false};
+	std::string error;
+
+	uint64 numBlocks {0};
+	double nanosecondsPerSample {0.};
+	double p50BlockMicroseconds {0.};
+	double p99BlockMicroseconds {0.};
+	double maxBlockMicroseconds {0.};
+	uint64 numAllocations {0};
+	uint64 numDeallocations {0};
+	uint64 numAllocatedBytes {0};
+	uint64 numMessages {0};
+};
+
+//------------------------------------------------------------------------
+/** Creates the plug-in, drives its process method with synthetic audio and measures it.
+ *
+ *	The plug-in is initialized, connected to a dummy connection point and activated like a host
+ *	would do it. Every call to process is timed and the allocations of the audio thread are
+ *	counted. The time needed to prepare the buffers and the parameter changes is not measured.
+ */
+BenchResult runBenchmark (const BenchPlugin& plugin, const BenchConfig& config,
+                          FUnknown* hostContext);
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
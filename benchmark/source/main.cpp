@@ -0,0 +1,245 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "benchrunner.h"
+#include "public.sdk/source/vst/hosting/hostclasses.h"
+#include "pluginterfaces/vst/ivstaudioprocessor.h"
+#include "pluginterfaces/vst/vstspeaker.h"
+#include "../../audiounit-tutorial/source/processor.h"
+#include "../../dataexchange-tutorial/source/processor.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+FUnknown* createProcessorInstance (void*);
+}
+
+//------------------------------------------------------------------------
+namespace {
+
+//------------------------------------------------------------------------
+/** Nothing reads a shared memory ring here, the host transport keeps the results comparable. */
+FUnknown* createDataExchangeProcessor (void*)
+{
+	auto processor = new DataExchangeProcessor;
+	auto config = processor->getStreamingConfig ();
+	config.transport = ExchangeTransport::Host;
+	processor->setStreamingConfig (config);
+	return static_cast<IAudioProcessor*> (processor);
+}
+
+//------------------------------------------------------------------------
+const BenchPlugin plugins[] = {
+    {"MyEffect", createProcessorInstance},
+    {"DataExchangeProcessor", createDataExchangeProcessor},
+    {"VST3AUPlugInProcessor", VST3AUPlugInProcessor::createInstance},
+};
+
+//------------------------------------------------------------------------
+struct Layout
+{
+	const char* name;
+	SpeakerArrangement arrangement;
+};
+
+const Layout layouts[] = {
+    {"mono", SpeakerArr::kMono},           {"stereo", SpeakerArr::kStereo},
+    {"5.1", SpeakerArr::k51},              {"7.1.4", SpeakerArr::k71_4},
+    {"ambi3", SpeakerArr::kAmbi3rdOrderACN},
+};
+
+//------------------------------------------------------------------------
+struct Options
+{
+	std::vector<std::string> plugins;
+	std::vector<double> sampleRates {48000.};
+	std::vector<int32> blockSizes {64, 256, 1024};
+	std::vector<std::string> layouts {"stereo"};
+	std::vector<bool> automation {false, true};
+	int32 symbolicSampleSize {kSample32};
+	double seconds {10.};
+};
+
+//------------------------------------------------------------------------
+std::vector<std::string> splitList (const char* list)
+{
+	std::vector<std::string> result;
+	std::string item;
+	for (auto c = list; *c; ++c)
+	{
+		if (*c == ',')
+		{
+			result.push_back (item);
+			item.clear ();
+		}
+		else
+			item += *c;
+	}
+	if (!item.empty ())
+		result.push_back (item);
+	return result;
+}
+
+//------------------------------------------------------------------------
+void printUsage ()
+{
+	std::printf (
+	    "usage: vst3_tutorial_bench [options]\n"
+	    "  --plugins <list>       plug-ins to run (default: all)\n"
+	    "  --sample-rates <list>  sample rates in Hz (default: 48000)\n"
+	    "  --block-sizes <list>   block sizes in samples (default: 64,256,1024)\n"
+	    "  --layouts <list>       mono, stereo, 5.1, 7.1.4, ambi3 (default: stereo)\n"
+	    "  --automation <mode>    off, on or both (default: both)\n"
+	    "  --double               process 64 bit samples\n"
+	    "  --seconds <value>      seconds of audio to render per run (default: 10)\n");
+}
+
+//------------------------------------------------------------------------
+bool parseOptions (int argc, char* argv[], Options& options)
+{
+	for (auto i = 1; i < argc; ++i)
+	{
+		auto arg = argv[i];
+		auto hasValue = i + 1 < argc;
+		if (std::strcmp (arg, "--double") == 0)
+			options.symbolicSampleSize = kSample64;
+		else if (std::strcmp (arg, "--plugins") == 0 && hasValue)
+			options.plugins = splitList (argv[++i]);
+		else if (std::strcmp (arg, "--layouts") == 0 && hasValue)
+			options.layouts = splitList (argv[++i]);
+		else if (std::strcmp (arg, "--seconds") == 0 && hasValue)
+			options.seconds = std::atof (argv[++i]);
+		else if (std::strcmp (arg, "--sample-rates") == 0 && hasValue)
+		{
+			options.sampleRates.clear ();
+			for (const auto& value : splitList (argv[++i]))
+				options.sampleRates.push_back (std::atof (value.data ()));
+		}
+		else if (std::strcmp (arg, "--block-sizes") == 0 && hasValue)
+		{
+			options.blockSizes.clear ();
+			for (const auto& value : splitList (argv[++i]))
+				options.blockSizes.push_back (std::atoi (value.data ()));
+		}
+		else if (std::strcmp (arg, "--automation") == 0 && hasValue)
+		{
+			std::string mode = argv[++i];
+			if (mode == "off")
+				options.automation = {false};
+			else if (mode == "on")
+				options.automation = {true};
+			else if (mode == "both")
+				options.automation = {false, true};
+			else
+				return false;
+		}
+		else
+			return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+const Layout* findLayout (const std::string& name)
+{
+	for (const auto& layout : layouts)
+	{
+		if (name == layout.name)
+			return &layout;
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------
+bool isSelected (const Options& options, const BenchPlugin& plugin)
+{
+	if (options.plugins.empty ())
+		return true;
+	for (const auto& name : options.plugins)
+	{
+		if (name == plugin.name)
+			return true;
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions (argc, argv, options))
+	{
+		printUsage ();
+		return 1;
+	}
+
+	auto hostContext = owned (new HostApplication ());
+	auto numFailures = 0;
+
+	std::printf ("%-22s %-7s %7s %6s %5s %9s %9s %9s %9s %7s %9s\n", "plug-in", "layout", "rate",
+	             "block", "auto", "ns/smp", "p50 us", "p99 us", "max us", "allocs", "bytes");
+	for (const auto& plugin : plugins)
+	{
+		if (!isSelected (options, plugin))
+			continue;
+		for (const auto& layoutName : options.layouts)
+		{
+			auto layout = findLayout (layoutName);
+			if (!layout)
+			{
+				std::printf ("unknown layout: %s\n", layoutName.data ());
+				return 1;
+			}
+			for (auto sampleRate : options.sampleRates)
+			{
+				for (auto blockSize : options.blockSizes)
+				{
+					for (auto automation : options.automation)
+					{
+						BenchConfig config;
+						config.sampleRate = sampleRate;
+						config.blockSize = blockSize;
+						config.arrangement = layout->arrangement;
+						config.symbolicSampleSize = options.symbolicSampleSize;
+						config.automation = automation;
+						config.secondsToProcess = options.seconds;
+
+						auto result = runBenchmark (plugin, config, hostContext);
+						std::printf ("%-22s %-7s %7.0f %6d %5s ", plugin.name, layout->name,
+						             sampleRate, blockSize, automation ? "on" : "off");
+						if (!result.valid)
+						{
+							std::printf ("skipped: %s\n", result.error.data ());
+							continue;
+						}
+						std::printf ("%9.3f %9.2f %9.2f %9.2f %7llu %9llu\n",
+						             result.nanosecondsPerSample, result.p50BlockMicroseconds,
+						             result.p99BlockMicroseconds, result.maxBlockMicroseconds,
+						             static_cast<unsigned long long> (result.numAllocations),
+						             static_cast<unsigned long long> (result.numAllocatedBytes));
+						if (result.numAllocations > 0 || result.numDeallocations > 0)
+							++numFailures;
+					}
+				}
+			}
+		}
+	}
+	if (numFailures > 0)
+	{
+		std::printf ("\n%d runs allocated memory in process\n", numFailures);
+		return 2;
+	}
+	return 0;
+}
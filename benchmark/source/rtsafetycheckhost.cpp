@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "../../common/source/rtsafetycheck.h"
+#include <cstdio>
+#include <dlfcn.h>
+#include <string>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+// Loads rtsafety_check_module like a host loads a plug-in and checks that the realtime safety check
+// inside of it sees the allocations and locks of the module. Like a C++ host the executable uses
+// the operator new and delete of libstdc++, which the module would call as well without
+// -Bsymbolic-functions. Exits with code 2 if a violation was missed or one outside of the scope
+// was counted.
+//------------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+	// uses libstdc++, so it is loaded before the module
+	std::string path = argc > 1 ? argv[1] : RTSAFETY_CHECK_MODULE;
+	auto module = dlopen (path.data (), RTLD_NOW | RTLD_LOCAL);
+	if (!module)
+	{
+		std::fprintf (stderr, "%s\n", dlerror ());
+		return 1;
+	}
+	using CheckFunc = void (*) (uint32, RTViolationCounts&);
+	auto check = reinterpret_cast<CheckFunc> (dlsym (module, "getRTSafetyCheckResult"));
+	if (!check)
+	{
+		std::fprintf (stderr, "%s\n", dlerror ());
+		dlclose (module);
+		return 1;
+	}
+
+	RTViolationCounts counts;
+	check (64, counts);
+	dlclose (module);
+	std::printf ("inside of RTSafetyCheckScope: %llu allocations (%llu bytes), %llu deallocations, "
+	             "%llu locks\n",
+	             static_cast<unsigned long long> (counts.numAllocations),
+	             static_cast<unsigned long long> (counts.numAllocatedBytes),
+	             static_cast<unsigned long long> (counts.numDeallocations),
+	             static_cast<unsigned long long> (counts.numLocks));
+	if (counts.numAllocations != 1 || counts.numAllocatedBytes != 64 ||
+	    counts.numDeallocations != 1 || counts.numLocks != 1)
+	{
+		std::fprintf (stderr, "expected 1 allocation of 64 bytes, 1 deallocation and 1 lock\n");
+		return 2;
+	}
+	return 0;
+}
@@ -0,0 +1,42 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "../../common/source/rtsafetycheck.h"
+#include <mutex>
+#include <new>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+// the allocations escape, so the compiler cannot remove them
+void* volatile lastAllocation {nullptr};
+std::mutex mutex;
+
+//------------------------------------------------------------------------
+void allocateAndLock (std::size_t size)
+{
+	lastAllocation = ::operator new (size);
+	::operator delete (lastAllocation);
+	std::lock_guard<std::mutex> lock (mutex);
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+/** Allocates, deallocates and locks once outside and once inside of a RTSafetyCheckScope and
+ *	returns the violations recorded. Built and linked like the tutorial plug-ins. */
+extern "C" SMTG_EXPORT_SYMBOL void getRTSafetyCheckResult (uint32 size, RTViolationCounts& counts)
+{
+	resetRTViolations ();
+	allocateAndLock (size);
+	{
+		RTSafetyCheckScope scope;
+		allocateAndLock (size);
+	}
+	counts = getRTViolationCounts ();
+}
@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/base/ftypes.h"
+#include <cstring>
+
+//------------------------------------------------------------------------
+// Helpers for in-place processing and silence flags.
+//
+// Hosts may pass the same buffer as input and output channel (in-place processing) and mark
+// channels which only contain zeros in AudioBusBuffers::silenceFlags. A silent input channel needs
+// neither processing nor copying: in place the output already is silent, otherwise the output is
+// cleared. The silence flags only cover the first 64 channels, channels above are never silent.
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+inline bool isChannelSilent (uint64 silenceFlags, int32 channel)
+{
+	return channel < 64 && (silenceFlags & (uint64 {1} << channel)) != 0;
+}
+
+//------------------------------------------------------------------------
+/** Mask of the silence flags used by numChannels channels. */
+inline uint64 getSilenceMask (int32 numChannels)
+{
+	return numChannels >= 64 ? ~uint64 {0} : (uint64 {1} << numChannels) - 1;
+}
+
+//------------------------------------------------------------------------
+/** Returns true if every output channel uses the same buffer as its input channel. */
+template <typename SampleType>
+inline bool isProcessingInPlace (SampleType* const* inputs, SampleType* const* outputs,
+                                 int32 numChannels)
+{
+	for (auto channel = 0; channel < numChannels; ++channel)
+	{
+		if (inputs[channel] != outputs[channel])
+			return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+/** Makes the output channel silent for a silent input channel, without touching it in place. */
+template <typename SampleType>
+inline void silenceOutputChannel (const SampleType* input, SampleType* output, int32 numSamples)
+{
+	if (output != input)
+		std::memset (output, 0, numSamples * sizeof (SampleType));
+}
+
+//------------------------------------------------------------------------
+/** Returns true if no sample of the buffer exceeds the threshold in magnitude.
+ *
+ *	Stops at the first sample above the threshold, so the check is cheap for audible signals. */
+template <typename SampleType>
+inline bool isBufferSilent (const SampleType* buffer, int32 numSamples, SampleType threshold)
+{
+	for (auto sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+	{
+		if (buffer[sampleIndex] > threshold || buffer[sampleIndex] < -threshold)
+			return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+/** Copies the input channels to the output channels and returns the output silence flags.
+ *
+ *	Channels processed in place are not touched and silent input channels are cleared in the
+ *	output instead of copied.
+ */
+template <typename SampleType>
+inline uint64 passThroughChannels (SampleType* const* inputs, SampleType* const* outputs,
+                                   int32 numChannels, int32 numSamples, uint64 inputSilenceFlags)
+{
+	auto outputSilenceFlags = inputSilenceFlags & getSilenceMask (numChannels);
+	if (isProcessingInPlace (inputs, outputs, numChannels))
+		return outputSilenceFlags;
+
+	for (auto channel = 0; channel < numChannels; ++channel)
+	{
+		if (inputs[channel] == outputs[channel])
+			continue;
+		if (isChannelSilent (inputSilenceFlags, channel))
+			std::memset (outputs[channel], 0, numSamples * sizeof (SampleType));
+		else
+			std::memcpy (outputs[channel], inputs[channel], numSamples * sizeof (SampleType));
+	}
+	return outputSilenceFlags;
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,382 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "rtsafetycheck.h"
+
+#if TUTORIAL_RT_SAFETY_CHECK
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <new>
+#include <pthread.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+//------------------------------------------------------------------------
+enum class ViolationType : uint32
+{
+	Allocation,
+	Deallocation,
+	Lock,
+};
+
+constexpr const char* violationNames[] = {"allocation", "deallocation", "lock"};
+
+// the frames of recordViolation and of the hook are not part of the call site
+constexpr int kSkipFrames = 2;
+constexpr int kMaxFrames = 12;
+// call sites with the same innermost frames are counted together
+constexpr int kMaxKeyFrames = 4;
+constexpr uint32 kMaxCallSites = 128;
+
+//------------------------------------------------------------------------
+struct CallSite
+{
+	std::atomic<uint64> key {0};
+	std::atomic<uint64> count {0};
+	std::atomic<bool> ready {false};
+	ViolationType type {ViolationType::Allocation};
+	int numFrames {0};
+	void* frames[kMaxFrames];
+};
+
+CallSite callSites[kMaxCallSites];
+std::atomic<uint64> numAllocations {0};
+std::atomic<uint64> numAllocatedBytes {0};
+std::atomic<uint64> numDeallocations {0};
+std::atomic<uint64> numLocks {0};
+std::atomic<uint64> numLostCallSites {0};
+// processors between beginRTViolationReport and reportRTViolations
+std::atomic<int32> numActiveProcessors {0};
+
+thread_local int realtimeScopeDepth = 0;
+thread_local bool insideHook = false;
+
+//------------------------------------------------------------------------
+// backtrace loads libgcc on its first call, which allocates. So call it once when the library is
+// loaded and not for the first time on the audio thread.
+struct BacktracePrimer
+{
+	BacktracePrimer ()
+	{
+		void* frames[1];
+		backtrace (frames, 1);
+	}
+} backtracePrimer;
+
+//------------------------------------------------------------------------
+uint64 hashCallSite (ViolationType type, void* const* frames, int numFrames)
+{
+	// FNV-1a
+	uint64 hash = 14695981039346656037ull ^ static_cast<uint64> (type);
+	for (auto index = 0; index < numFrames; ++index)
+	{
+		hash ^= reinterpret_cast<uint64> (frames[index]);
+		hash *= 1099511628211ull;
+	}
+	return hash == 0 ? 1 : hash;
+}
+
+//------------------------------------------------------------------------
+void addCallSite (ViolationType type, void* const* frames, int numFrames)
+{
+	auto key = hashCallSite (type, frames, numFrames < kMaxKeyFrames ? numFrames : kMaxKeyFrames);
+	for (auto probe = 0u; probe < kMaxCallSites; ++probe)
+	{
+		auto& callSite = callSites[(key + probe) % kMaxCallSites];
+		auto existingKey = callSite.key.load (std::memory_order_acquire);
+		if (existingKey == 0 &&
+		    callSite.key.compare_exchange_strong (existingKey, key, std::memory_order_acq_rel))
+		{
+			callSite.type = type;
+			callSite.numFrames = numFrames;
+			for (auto index = 0; index < numFrames; ++index)
+				callSite.frames[index] = frames[index];
+			callSite.ready.store (true, std::memory_order_release);
+			existingKey = key;
+		}
+		if (existingKey == key)
+		{
+			callSite.count.fetch_add (1, std::memory_order_relaxed);
+			return;
+		}
+	}
+	numLostCallSites.fetch_add (1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+void recordViolation (ViolationType type, std::size_t size = 0)
+{
+	if (realtimeScopeDepth == 0 || insideHook)
+		return;
+	insideHook = true;
+
+	switch (type)
+	{
+		case ViolationType::Allocation:
+			numAllocations.fetch_add (1, std::memory_order_relaxed);
+			numAllocatedBytes.fetch_add (size, std::memory_order_relaxed);
+			break;
+		case ViolationType::Deallocation:
+			numDeallocations.fetch_add (1, std::memory_order_relaxed);
+			break;
+		case ViolationType::Lock:
+			numLocks.fetch_add (1, std::memory_order_relaxed);
+			break;
+	}
+
+	void* frames[kMaxFrames + kSkipFrames];
+	auto numFrames = backtrace (frames, kMaxFrames + kSkipFrames);
+	if (numFrames > kSkipFrames)
+		addCallSite (type, frames + kSkipFrames, numFrames - kSkipFrames);
+
+	insideHook = false;
+}
+
+//------------------------------------------------------------------------
+template <typename Func>
+Func nextFunction (std::atomic<Func>& function, const char* name)
+{
+	auto result = function.load (std::memory_order_relaxed);
+	if (!result)
+	{
+		result = reinterpret_cast<Func> (dlsym (RTLD_NEXT, name));
+		function.store (result, std::memory_order_relaxed);
+	}
+	return result;
+}
+
+using MutexFunc = int (*) (pthread_mutex_t*);
+using RWLockFunc = int (*) (pthread_rwlock_t*);
+
+std::atomic<MutexFunc> nextMutexLock {nullptr};
+std::atomic<RWLockFunc> nextRWLockRead {nullptr};
+std::atomic<RWLockFunc> nextRWLockWrite {nullptr};
+
+//------------------------------------------------------------------------
+void* allocate (std::size_t size, std::size_t alignment = 0)
+{
+	recordViolation (ViolationType::Allocation, size);
+	if (size == 0)
+		size = 1;
+	if (alignment > alignof (std::max_align_t))
+	{
+		void* ptr = nullptr;
+		if (posix_memalign (&ptr, alignment, size) != 0)
+			return nullptr;
+		return ptr;
+	}
+	return std::malloc (size);
+}
+
+//------------------------------------------------------------------------
+void* allocateOrThrow (std::size_t size, std::size_t alignment = 0)
+{
+	if (auto ptr = allocate (size, alignment))
+		return ptr;
+	throw std::bad_alloc ();
+}
+
+//------------------------------------------------------------------------
+void deallocate (void* ptr) noexcept
+{
+	if (!ptr)
+		return;
+	recordViolation (ViolationType::Deallocation);
+	std::free (ptr);
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+RTSafetyCheckScope::RTSafetyCheckScope () noexcept
+{
+	++realtimeScopeDepth;
+}
+
+//------------------------------------------------------------------------
+RTSafetyCheckScope::~RTSafetyCheckScope () noexcept
+{
+	--realtimeScopeDepth;
+}
+
+//------------------------------------------------------------------------
+RTViolationCounts getRTViolationCounts ()
+{
+	RTViolationCounts counts;
+	counts.numAllocations = numAllocations.load (std::memory_order_relaxed);
+	counts.numAllocatedBytes = numAllocatedBytes.load (std::memory_order_relaxed);
+	counts.numDeallocations = numDeallocations.load (std::memory_order_relaxed);
+	counts.numLocks = numLocks.load (std::memory_order_relaxed);
+	return counts;
+}
+
+//------------------------------------------------------------------------
+void resetRTViolations ()
+{
+	for (auto& callSite : callSites)
+	{
+		callSite.ready.store (false, std::memory_order_relaxed);
+		callSite.count.store (0, std::memory_order_relaxed);
+		callSite.key.store (0, std::memory_order_release);
+	}
+	numAllocations = 0;
+	numAllocatedBytes = 0;
+	numDeallocations = 0;
+	numLocks = 0;
+	numLostCallSites = 0;
+}
+
+//------------------------------------------------------------------------
+void beginRTViolationReport ()
+{
+	numActiveProcessors.fetch_add (1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+void reportRTViolations (const char* processorName)
+{
+	// a deactivation without activation does not count
+	auto numActive = numActiveProcessors.load (std::memory_order_relaxed);
+	while (numActive > 0 && !numActiveProcessors.compare_exchange_weak (numActive, numActive - 1))
+	{
+	}
+	auto numStillActive = numActive > 0 ? numActive - 1 : 0;
+
+	auto counts = getRTViolationCounts ();
+	if (counts.numAllocations == 0 && counts.numDeallocations == 0 && counts.numLocks == 0)
+		return;
+
+	auto fd = STDERR_FILENO;
+	if (auto path = std::getenv ("TUTORIAL_RT_SAFETY_LOG"))
+	{
+		auto logFile = open (path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+		if (logFile >= 0)
+			fd = logFile;
+	}
+
+	dprintf (fd,
+	         "[%s] realtime violations in process of all instances, %d still active: %llu "
+	         "allocations (%llu bytes), %llu deallocations, %llu locks\n",
+	         processorName, numStillActive,
+	         static_cast<unsigned long long> (counts.numAllocations),
+	         static_cast<unsigned long long> (counts.numAllocatedBytes),
+	         static_cast<unsigned long long> (counts.numDeallocations),
+	         static_cast<unsigned long long> (counts.numLocks));
+	for (auto& callSite : callSites)
+	{
+		if (!callSite.ready.load (std::memory_order_acquire))
+			continue;
+		dprintf (fd, "%llu x %s at:\n",
+		         static_cast<unsigned long long> (callSite.count.load (std::memory_order_relaxed)),
+		         violationNames[static_cast<uint32> (callSite.type)]);
+		backtrace_symbols_fd (callSite.frames, callSite.numFrames, fd);
+	}
+	if (auto lost = numLostCallSites.load (std::memory_order_relaxed))
+		dprintf (fd, "%llu violations without call site, the table is full\n",
+		         static_cast<unsigned long long> (lost));
+
+	if (fd != STDERR_FILENO)
+		close (fd);
+	// the other instances still add to the counts and report them later
+	if (numStillActive == 0)
+		resetRTViolations ();
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
+
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+// pthread hooks, forwarding to the next definition (libc)
+//------------------------------------------------------------------------
+extern "C" int pthread_mutex_lock (pthread_mutex_t* mutex)
+{
+	recordViolation (ViolationType::Lock);
+	return nextFunction (nextMutexLock, "pthread_mutex_lock") (mutex);
+}
+
+extern "C" int pthread_rwlock_rdlock (pthread_rwlock_t* rwlock)
+{
+	recordViolation (ViolationType::Lock);
+	return nextFunction (nextRWLockRead, "pthread_rwlock_rdlock") (rwlock);
+}
+
+extern "C" int pthread_rwlock_wrlock (pthread_rwlock_t* rwlock)
+{
+	recordViolation (ViolationType::Lock);
+	return nextFunction (nextRWLockWrite, "pthread_rwlock_wrlock") (rwlock);
+}
+
+//------------------------------------------------------------------------
+// Replacements of the global allocation functions
+//------------------------------------------------------------------------
+void* operator new (std::size_t size)
+{
+	return allocateOrThrow (size);
+}
+void* operator new[] (std::size_t size)
+{
+	return allocateOrThrow (size);
+}
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate (size);
+}
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate (size);
+}
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+	return allocateOrThrow (size, static_cast<std::size_t> (alignment));
+}
+void* operator new[] (std::size_t size, std::align_val_t alignment)
+{
+	return allocateOrThrow (size, static_cast<std::size_t> (alignment));
+}
+void operator delete (void* ptr) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete[] (void* ptr) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete (void* ptr, std::size_t) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete[] (void* ptr, std::size_t) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete (void* ptr, std::align_val_t) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete[] (void* ptr, std::align_val_t) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete (void* ptr, std::size_t, std::align_val_t) noexcept
+{
+	deallocate (ptr);
+}
+void operator delete[] (void* ptr, std::size_t, std::align_val_t) noexcept
+{
+	deallocate (ptr);
+}
+
+#endif // TUTORIAL_RT_SAFETY_CHECK
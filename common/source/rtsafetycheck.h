@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/base/ftypes.h"
+
+//------------------------------------------------------------------------
+// Opt-in detection of allocations and locks on the audio thread.
+//
+// Build with TUTORIAL_RT_SAFETY_CHECK=1 (cmake option SMTG_ENABLE_TUTORIAL_RT_SAFETY_CHECK, Linux
+// only) to hook operator new/delete and the pthread mutex and rwlock functions. Every call made
+// while a RTSafetyCheckScope is alive on the calling thread is recorded with its call stack.
+// Link the plug-in with -Bsymbolic-functions as the cmake option does, or a C++ host's operator
+// new and delete replace the hooks. Without the define the scope is an empty object and all
+// functions do nothing.
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+struct RTViolationCounts
+{
+	uint64 numAllocations {0};
+	uint64 numAllocatedBytes {0};
+	uint64 numDeallocations {0};
+	uint64 numLocks {0};
+};
+
+#if TUTORIAL_RT_SAFETY_CHECK
+//------------------------------------------------------------------------
+/** Marks the calling thread as realtime thread while the scope exists. */
+struct RTSafetyCheckScope
+{
+	RTSafetyCheckScope () noexcept;
+	~RTSafetyCheckScope () noexcept;
+};
+
+//------------------------------------------------------------------------
+/** Returns the number of violations recorded since the last reset or report. */
+RTViolationCounts getRTViolationCounts ();
+void resetRTViolations ();
+
+//------------------------------------------------------------------------
+/** Counts an active processor, call it when the processor is activated. */
+void beginRTViolationReport ();
+
+//------------------------------------------------------------------------
+/** Writes the recorded violations with their call stacks to the log, call it when the processor
+ *	is deactivated.
+ *
+ *	The hooks cannot tell the instances apart, so the report covers all instances of the process
+ *	and is labeled with the name of the one being deactivated. The violations are only reset when
+ *	the last active instance is deactivated, the report of every other one includes them.
+ *	The log is the file named by the environment variable TUTORIAL_RT_SAFETY_LOG or stderr.
+ */
+void reportRTViolations (const char* processorName);
+
+#else
+//------------------------------------------------------------------------
+struct RTSafetyCheckScope
+{
+};
+
+inline RTViolationCounts getRTViolationCounts () { return {}; }
+inline void resetRTViolations () {}
+inline void beginRTViolationReport () {}
+inline void reportRTViolations (const char*) {}
+
+#endif // TUTORIAL_RT_SAFETY_CHECK
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
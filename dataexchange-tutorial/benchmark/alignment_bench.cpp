@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "dataexchange.h"
+#include "payloadkernels.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+constexpr int32 kNumChannels = 8;
+constexpr int32 kNumFrames = 1000;
+constexpr int64 kSamplesToProcess = int64 {1} << 28;
+
+//------------------------------------------------------------------------
+struct Layout
+{
+	const char* name;
+	uint32 headerSize;
+	uint32 channelStride;
+};
+
+// the previous layout: 48 byte header and the requested frame count as channel stride
+constexpr Layout layouts[] = {
+    {"packed", 48, kNumFrames},
+    {"aligned", sizeof (DataBlock),
+     getAlignedFrameCount (kNumFrames, PayloadFormat::Planar, kDataBlockAlignment)},
+};
+
+//------------------------------------------------------------------------
+/** Nanoseconds per sample for writing the channels into a block and reducing them again. */
+void measureLayout (const Layout& layout, double& producer, double& consumer)
+{
+	auto blockSize = layout.headerSize + layout.channelStride * kNumChannels * sizeof (float);
+	std::vector<DataBlockStorage> storage ((blockSize + kDataBlockAlignment - 1) /
+	                                       kDataBlockAlignment);
+	auto samples = reinterpret_cast<float*> (storage.data ()->bytes + layout.headerSize);
+	std::vector<std::vector<float>> inputs (kNumChannels, std::vector<float> (kNumFrames));
+	for (auto channel = 0; channel < kNumChannels; ++channel)
+	{
+		for (auto index = 0; index < kNumFrames; ++index)
+			inputs[channel][index] = static_cast<float> ((index * 7 + channel) % 100) * 0.01f;
+	}
+
+	auto numBlocks = kSamplesToProcess / (kNumFrames * kNumChannels);
+	auto start = std::chrono::steady_clock::now ();
+	for (int64 blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+	{
+		for (auto channel = 0; channel < kNumChannels; ++channel)
+			std::memcpy (samples + channel * layout.channelStride, inputs[channel].data (),
+			             kNumFrames * sizeof (float));
+	}
+	auto middle = std::chrono::steady_clock::now ();
+	DecimationAccumulator accumulator;
+	for (int64 blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+	{
+		for (auto channel = 0; channel < kNumChannels; ++channel)
+			accumulate (samples + channel * layout.channelStride, kNumFrames, accumulator);
+		if (accumulator.numSamples > (1 << 20))
+			accumulator.reset ();
+	}
+	auto end = std::chrono::steady_clock::now ();
+
+	// make sure the compiler cannot discard the results
+	volatile float sink = accumulator.sumOfSquares + samples[kNumFrames / 2];
+	(void)sink;
+
+	auto numSamples = static_cast<double> (numBlocks) * kNumFrames * kNumChannels;
+	producer = std::chrono::duration<double, std::nano> (middle - start).count () / numSamples;
+	consumer = std::chrono::duration<double, std::nano> (end - middle).count () / numSamples;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main ()
+{
+	std::printf ("%d channels of %d frames\n\n", kNumChannels, kNumFrames);
+	std::printf ("%-8s %7s %7s %12s %12s\n", "layout", "header", "stride", "producer ns",
+	             "consumer ns");
+	for (const auto& layout : layouts)
+	{
+		double producer = 0.;
+		double consumer = 0.;
+		measureLayout (layout, producer, consumer);
+		std::printf ("%-8s %7u %7u %12.4f %12.4f\n", layout.name, layout.headerSize,
+		             layout.channelStride, producer, consumer);
+	}
+	return 0;
+}
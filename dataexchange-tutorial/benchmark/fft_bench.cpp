@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "fft.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+constexpr uint32 kSamplesToTransform = 1u << 25;
+
+//------------------------------------------------------------------------
+/** Nanoseconds per transform. */
+double measureTransform (uint32 size, FFT::Implementation implementation)
+{
+	FFT fft;
+	fft.setup (size, implementation);
+	std::vector<float> input (size);
+	std::vector<float> real (size / 2 + 1);
+	std::vector<float> imag (size / 2 + 1);
+	for (auto index = 0u; index < size; ++index)
+		input[index] = static_cast<float> (std::sin (index * 0.1) + 0.25 * std::cos (index * 0.7));
+
+	auto numTransforms = kSamplesToTransform / size;
+	auto start = std::chrono::steady_clock::now ();
+	for (auto index = 0u; index < numTransforms; ++index)
+	{
+		fft.forward (input.data (), real.data (), imag.data ());
+		input[index % size] += real[1] * 1e-9f;
+	}
+	auto end = std::chrono::steady_clock::now ();
+
+	auto nanoseconds = std::chrono::duration<double, std::nano> (end - start).count ();
+	return nanoseconds / numTransforms;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main ()
+{
+	std::printf ("%8s %14s %14s %9s %16s\n", "size", "scalar ns", "simd ns", "speedup",
+	             "simd MSamples/s");
+	for (uint32 size = 512; size <= 32768; size *= 2)
+	{
+		auto scalar = measureTransform (size, FFT::Implementation::Scalar);
+		auto simd = measureTransform (size, FFT::Implementation::SIMD);
+		std::printf ("%8u %14.0f %14.0f %8.2fx %16.1f\n", size, scalar, simd, scalar / simd,
+		             size * 1e3 / simd);
+	}
+	return 0;
+}
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "loudness.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+constexpr uint32 kNumInstances = 64;
+constexpr uint32 kNumChannels = 2;
+constexpr uint32 kBlockSize = 1024;
+constexpr double kSecondsOfAudio = 10.;
+
+//------------------------------------------------------------------------
+/** Seconds of one core needed to meter kSecondsOfAudio seconds for all instances. */
+double measureSeconds (double sampleRate)
+{
+	std::vector<LoudnessMeter> meters (kNumInstances);
+	for (auto& meter : meters)
+		meter.setup (sampleRate, kNumChannels);
+
+	// noise like signal, every instance gets the same blocks
+	std::vector<std::vector<float>> audio (kNumChannels, std::vector<float> (kBlockSize));
+	uint32 random = 1;
+	for (auto& channel : audio)
+	{
+		for (auto& sample : channel)
+		{
+			random = random * 1664525u + 1013904223u;
+			sample = (static_cast<float> (random >> 8) / 16777216.f - 0.5f) * 0.5f;
+		}
+	}
+	const float* channels[kNumChannels] = {audio[0].data (), audio[1].data ()};
+
+	auto numBlocks = static_cast<uint32> (kSecondsOfAudio * sampleRate / kBlockSize);
+	auto start = std::chrono::steady_clock::now ();
+	for (auto blockIndex = 0u; blockIndex < numBlocks; ++blockIndex)
+	{
+		for (auto& meter : meters)
+			meter.process (channels, kBlockSize);
+	}
+	auto end = std::chrono::steady_clock::now ();
+
+	// make sure the compiler cannot discard the measurement
+	volatile double sink = meters.back ().getIntegratedLoudness ();
+	(void)sink;
+
+	return std::chrono::duration<double> (end - start).count ();
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main ()
+{
+	std::printf ("loudness meter: %u instances, %u channels, block size %u\n\n", kNumInstances,
+	             kNumChannels, kBlockSize);
+	std::printf ("%12s %16s %16s\n", "sample rate", "ns per sample", "core load");
+	for (auto sampleRate : {44100., 48000., 96000., 192000.})
+	{
+		auto seconds = measureSeconds (sampleRate);
+		auto numSamples = kSecondsOfAudio * sampleRate * kNumChannels * kNumInstances;
+		std::printf ("%12.0f %16.3f %15.1f%%\n", sampleRate, seconds * 1e9 / numSamples,
+		             seconds / kSecondsOfAudio * 100.);
+	}
+	return 0;
+}
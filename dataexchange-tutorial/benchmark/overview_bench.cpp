@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "waveformoverview.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+constexpr uint16 kNumChannels = 2;
+constexpr uint32 kSampleRate = 48000;
+constexpr uint32 kFramesPerBlock = 1024;
+constexpr uint32 kNumPixels = 1000;
+constexpr uint32 kNumRenders = 100;
+
+//------------------------------------------------------------------------
+double getMicroseconds (std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now () - start;
+	return duration.count ();
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main ()
+{
+	auto channelStride = getAlignedFrameCount (kFramesPerBlock, PayloadFormat::Planar,
+	                                           kDataBlockAlignment);
+	auto blockSize = static_cast<uint32> (sizeof (DataBlock) +
+	                                      channelStride * kNumChannels * sizeof (float));
+	std::vector<DataBlockStorage> storage ((blockSize + kDataBlockAlignment - 1) /
+	                                       kDataBlockAlignment);
+	auto block = reinterpret_cast<DataBlock*> (storage.data ());
+	*block = {};
+	block->sampleRate = kSampleRate;
+	block->sampleSize = sizeof (float);
+	block->numChannels = kNumChannels;
+	block->numSamples = kFramesPerBlock;
+	block->channelStride = channelStride;
+	block->payloadFormat = PayloadFormat::Planar;
+	block->decimation = 1;
+	block->frameStride = 1;
+
+	// the default retention window of one hour, appended for two hours
+	WaveformOverview overview;
+	overview.reset (OverviewConfig {}, kNumChannels);
+	std::vector<WaveformRange> pixels (kNumPixels);
+	std::printf ("%d channels at %d Hz, %d frames per block, %d pixels\n\n", kNumChannels,
+	             kSampleRate, kFramesPerBlock, kNumPixels);
+	std::printf ("%8s %14s %10s %12s %12s %12s\n", "minutes", "append ns/frm", "KB",
+	             "all us", "1 s us", "10 ms us");
+	uint64 position = 0;
+	for (auto minutes = 15u; minutes <= 120; minutes += 15)
+	{
+		auto numBlocks = uint64 {kSampleRate} * 60 * 15 / kFramesPerBlock;
+		double appendMicroseconds = 0.;
+		for (uint64 blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+		{
+			for (auto channel = 0u; channel < kNumChannels; ++channel)
+			{
+				auto samples = getChannelSamples (block, channel);
+				for (auto frame = 0u; frame < kFramesPerBlock; ++frame)
+					samples[frame] = static_cast<float> (
+					    std::sin ((position + frame) * 0.001 * (channel + 1)) * 0.5);
+			}
+			block->samplePosition = position;
+			auto start = std::chrono::steady_clock::now ();
+			overview.append (block);
+			appendMicroseconds += getMicroseconds (start);
+			position += kFramesPerBlock;
+		}
+
+		// the whole window, the last second and the last 10 ms
+		uint64 begin = 0;
+		uint64 end = 0;
+		overview.getPositions (begin, end);
+		double renderMicroseconds[3] = {};
+		uint64 lengths[3] = {end - begin, kSampleRate, kSampleRate / 100};
+		for (auto view = 0u; view < 3; ++view)
+		{
+			auto start = std::chrono::steady_clock::now ();
+			for (auto render = 0u; render < kNumRenders; ++render)
+				overview.render (0, end - lengths[view], end, pixels.data (), kNumPixels);
+			renderMicroseconds[view] = getMicroseconds (start) / kNumRenders;
+		}
+		std::printf ("%8u %14.2f %10llu %12.1f %12.1f %12.1f\n", minutes,
+		             appendMicroseconds * 1000. / (numBlocks * kFramesPerBlock),
+		             static_cast<unsigned long long> (overview.getMemorySize () / 1024),
+		             renderMicroseconds[0], renderMicroseconds[1], renderMicroseconds[2]);
+	}
+	return 0;
+}
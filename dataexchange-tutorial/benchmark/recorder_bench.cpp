@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "blockrecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+constexpr uint16 kNumChannels = 32;
+constexpr uint32 kSampleRate = 192000;
+constexpr uint32 kFramesPerBlock = 1024;
+constexpr double kSecondsToRun = 4.;
+
+//------------------------------------------------------------------------
+struct Result
+{
+	RecorderStatistics statistics;
+	double meanPushMicroseconds {0.};
+	double maxPushMicroseconds {0.};
+};
+
+//------------------------------------------------------------------------
+/** Pushes planar blocks speed times faster than real time, like the receiving thread would. */
+Result measureRecording (const std::string& path, double speed)
+{
+	auto channelStride = getAlignedFrameCount (kFramesPerBlock, PayloadFormat::Planar,
+	                                           kDataBlockAlignment);
+	auto blockSize = static_cast<uint32> (sizeof (DataBlock) +
+	                                      channelStride * kNumChannels * sizeof (float));
+	std::vector<DataBlockStorage> storage ((blockSize + kDataBlockAlignment - 1) /
+	                                       kDataBlockAlignment);
+	auto block = reinterpret_cast<DataBlock*> (storage.data ());
+	*block = {};
+	block->sampleRate = kSampleRate;
+	block->sampleSize = sizeof (float);
+	block->numChannels = kNumChannels;
+	block->numSamples = kFramesPerBlock;
+	block->channelStride = channelStride;
+	block->payloadFormat = PayloadFormat::Planar;
+	block->decimation = 1;
+	block->frameStride = 1;
+	for (auto channel = 0u; channel < kNumChannels; ++channel)
+	{
+		auto samples = getChannelSamples (block, channel);
+		for (auto frame = 0u; frame < kFramesPerBlock; ++frame)
+			samples[frame] = static_cast<float> (std::sin (frame * 0.01 * (channel + 1)) * 0.5);
+	}
+
+	BlockRecorder recorder;
+	if (!recorder.start (path, {}, blockSize))
+		return {};
+
+	Result result;
+	auto numBlocks = static_cast<uint64> (kSecondsToRun * speed * kSampleRate / kFramesPerBlock);
+	auto blockDuration = std::chrono::duration<double> (kFramesPerBlock / (kSampleRate * speed));
+	auto start = std::chrono::steady_clock::now ();
+	for (uint64 blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+	{
+		block->samplePosition = blockIndex * kFramesPerBlock;
+		auto pushStart = std::chrono::steady_clock::now ();
+		recorder.push (block, blockSize);
+		std::chrono::duration<double, std::micro> pushDuration =
+		    std::chrono::steady_clock::now () - pushStart;
+		auto microseconds = pushDuration.count ();
+		result.meanPushMicroseconds += microseconds / numBlocks;
+		result.maxPushMicroseconds = std::max (result.maxPushMicroseconds, microseconds);
+		std::this_thread::sleep_until (
+		    start + std::chrono::duration_cast<std::chrono::steady_clock::duration> (
+		                blockDuration * static_cast<double> (blockIndex + 1)));
+	}
+	recorder.stop ();
+	result.statistics = recorder.getStatistics ();
+	std::remove (path.data ());
+	return result;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main (int argc, char* argv[])
+{
+	// the file system of the file decides whether direct I/O is used
+	std::string path = argc > 1 ? argv[1] : "recorder_bench.w64";
+	std::printf ("%d channels at %d Hz, %d frames per block, %s\n\n", kNumChannels, kSampleRate,
+	             kFramesPerBlock, path.data ());
+	std::printf ("%6s %10s %10s %12s %12s\n", "speed", "MB", "lost", "push us", "max push us");
+	for (auto speed : {1., 2., 4., 8.})
+	{
+		auto result = measureRecording (path, speed);
+		if (result.statistics.bytesWritten == 0)
+		{
+			std::printf ("cannot record to %s\n", path.data ());
+			return 1;
+		}
+		std::printf ("%5.0fx %10.1f %10u %12.1f %12.1f%s\n", speed,
+		             result.statistics.bytesWritten / 1e6, result.statistics.blocksLost,
+		             result.meanPushMicroseconds, result.maxPushMicroseconds,
+		             result.statistics.writeFailed ? " write failed" : "");
+	}
+	return 0;
+}
@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "dataexchange.h"
+#include "payloadkernels.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+constexpr int32 kNumChannels = 8;
+constexpr int32 kNumFrames = 1024;
+constexpr int64 kSamplesToProcess = int64 {1} << 28;
+
+//------------------------------------------------------------------------
+struct Input
+{
+	std::vector<std::vector<double>> channels64;
+	std::vector<std::vector<float>> channels32;
+	// the float copy a host makes for a plug-in without 64-bit support
+	std::vector<std::vector<float>> converted;
+	std::vector<const double*> pointers64;
+	std::vector<const float*> pointers32;
+};
+
+//------------------------------------------------------------------------
+/** Nanoseconds per sample of writing numBlocks blocks with proc (float* samples). */
+template <typename Proc>
+double measure (Proc proc)
+{
+	std::vector<float> samples (kNumFrames * kNumChannels);
+	auto numBlocks = kSamplesToProcess / (kNumFrames * kNumChannels);
+	auto start = std::chrono::steady_clock::now ();
+	for (int64 blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+		proc (samples.data ());
+	auto end = std::chrono::steady_clock::now ();
+
+	// make sure the compiler cannot discard the results
+	volatile float sink = samples[kNumFrames / 2];
+	(void)sink;
+
+	auto numSamples = static_cast<double> (numBlocks) * kNumFrames * kNumChannels;
+	return std::chrono::duration<double, std::nano> (end - start).count () / numSamples;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main ()
+{
+	Input input;
+	input.channels64.assign (kNumChannels, std::vector<double> (kNumFrames));
+	input.channels32.assign (kNumChannels, std::vector<float> (kNumFrames));
+	input.converted.assign (kNumChannels, std::vector<float> (kNumFrames));
+	for (auto channel = 0; channel < kNumChannels; ++channel)
+	{
+		for (auto index = 0; index < kNumFrames; ++index)
+		{
+			auto value = static_cast<double> ((index * 7 + channel) % 100) * 0.01;
+			input.channels64[channel][index] = value;
+			input.channels32[channel][index] = static_cast<float> (value);
+		}
+		input.pointers64.push_back (input.channels64[channel].data ());
+		input.pointers32.push_back (input.channels32[channel].data ());
+	}
+
+	std::printf ("%d channels of %d frames, ns per sample\n\n", kNumChannels, kNumFrames);
+	std::printf ("%-34s %10s %12s\n", "input", "planar", "interleaved");
+
+	auto planar32 = measure ([&] (float* samples) {
+		for (auto channel = 0; channel < kNumChannels; ++channel)
+			std::memcpy (samples + channel * kNumFrames, input.pointers32[channel],
+			             kNumFrames * sizeof (float));
+	});
+	auto interleaved32 = measure ([&] (float* samples) {
+		interleaveChannels (input.pointers32.data (), kNumChannels, kNumFrames, samples);
+	});
+	std::printf ("%-34s %10.4f %12.4f\n", "float", planar32, interleaved32);
+
+	// the host converts every input channel before the plug-in copies it
+	auto convertInHost = [&] () {
+		for (auto channel = 0; channel < kNumChannels; ++channel)
+		{
+			auto& converted = input.converted[channel];
+			for (auto index = 0; index < kNumFrames; ++index)
+				converted[index] = static_cast<float> (input.pointers64[channel][index]);
+		}
+	};
+	auto planarHost = measure ([&] (float* samples) {
+		convertInHost ();
+		for (auto channel = 0; channel < kNumChannels; ++channel)
+			std::memcpy (samples + channel * kNumFrames, input.converted[channel].data (),
+			             kNumFrames * sizeof (float));
+	});
+	auto interleavedHost = measure ([&] (float* samples) {
+		convertInHost ();
+		for (auto channel = 0; channel < kNumChannels; ++channel)
+			input.pointers32[channel] = input.converted[channel].data ();
+		interleaveChannels (input.pointers32.data (), kNumChannels, kNumFrames, samples);
+	});
+	std::printf ("%-34s %10.4f %12.4f\n", "double, converted by the host", planarHost,
+	             interleavedHost);
+
+	auto planar64 = measure ([&] (float* samples) {
+		for (auto channel = 0; channel < kNumChannels; ++channel)
+			convertToFloat (input.pointers64[channel], kNumFrames, samples + channel * kNumFrames);
+	});
+	auto interleaved64 = measure ([&] (float* samples) {
+		interleaveChannels (input.pointers64.data (), kNumChannels, kNumFrames, samples);
+	});
+	std::printf ("%-34s %10.4f %12.4f\n", "double, converted into the block", planar64,
+	             interleaved64);
+	return 0;
+}
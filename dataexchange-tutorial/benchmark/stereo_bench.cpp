@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "dataexchange.h"
+#include "payloadkernels.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace Steinberg;
+using namespace Steinberg::Tutorial;
+
+//------------------------------------------------------------------------
+namespace {
+
+constexpr int32 kNumFrames = 1024;
+constexpr int64 kFramesToProcess = int64 {1} << 28;
+constexpr double kSampleRate = 48000.;
+
+//------------------------------------------------------------------------
+/** Nanoseconds per stereo frame of calling proc () for blocks of kNumFrames frames. */
+template <typename Proc>
+double measure (Proc proc)
+{
+	auto numBlocks = kFramesToProcess / kNumFrames;
+	auto start = std::chrono::steady_clock::now ();
+	for (int64 blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+		proc ();
+	auto end = std::chrono::steady_clock::now ();
+	return std::chrono::duration<double, std::nano> (end - start).count () / kFramesToProcess;
+}
+
+//------------------------------------------------------------------------
+/** The points of one block, with the decimation of the stream. */
+template <typename SampleType>
+double measureReduction (const std::vector<SampleType>& left, const std::vector<SampleType>& right,
+                         uint32 decimation, std::vector<StereoPoint>& points)
+{
+	StereoCorrelation correlation;
+	correlation.setup (kSampleRate, 0.3f);
+	return measure ([&] () {
+		for (auto frame = 0u; frame + decimation <= kNumFrames; frame += decimation)
+		{
+			StereoAccumulator accumulator;
+			accumulateStereo (left.data () + frame, right.data () + frame,
+			                  static_cast<int32> (decimation), accumulator);
+			points[frame / decimation] = correlation.addPoint (accumulator);
+		}
+	});
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+int main ()
+{
+	std::vector<float> left (kNumFrames);
+	std::vector<float> right (kNumFrames);
+	std::vector<double> left64 (kNumFrames);
+	std::vector<double> right64 (kNumFrames);
+	for (auto index = 0; index < kNumFrames; ++index)
+	{
+		left64[index] = std::sin (index * 0.05) * 0.5;
+		right64[index] = std::sin (index * 0.05 + 0.5) * 0.5;
+		left[index] = static_cast<float> (left64[index]);
+		right[index] = static_cast<float> (right64[index]);
+	}
+	std::vector<StereoPoint> points (kNumFrames);
+	std::vector<float> planar (kNumFrames * 2);
+
+	// the tutorial streams planar float by default, the copy is the cost to beat
+	auto copy = measure ([&] () {
+		std::memcpy (planar.data (), left.data (), kNumFrames * sizeof (float));
+		std::memcpy (planar.data () + kNumFrames, right.data (), kNumFrames * sizeof (float));
+	});
+	auto planarBytes = 2 * sizeof (float) * kSampleRate;
+	std::printf ("stereo frames of %d, ns per frame, exchanged KB per second at %.0f Hz\n\n",
+	             kNumFrames, kSampleRate);
+	std::printf ("%-24s %10s %10s %10s\n", "payload", "float", "double", "KB/s");
+	std::printf ("%-24s %10.3f %10s %10.1f\n", "Planar", copy, "", planarBytes / 1000.);
+	for (auto decimation : {16u, 64u, 256u})
+	{
+		auto time32 = measureReduction (left, right, decimation, points);
+		auto time64 = measureReduction (left64, right64, decimation, points);
+		auto stereoBytes = sizeof (StereoPoint) * kSampleRate / decimation;
+		std::printf ("Stereo, decimation %-5u %10.3f %10.3f %10.1f\n", decimation, time32, time64,
+		             stereoBytes / 1000.);
+	}
+
+	// make sure the compiler cannot discard the results
+	volatile float sink = points[0].correlation + planar[kNumFrames / 2];
+	(void)sink;
+	return 0;
+}
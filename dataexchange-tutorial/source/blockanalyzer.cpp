@@ -0,0 +1,273 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "blockanalyzer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+//------------------------------------------------------------------------
+inline void addPoint (float min, float max, float sumOfSquares, uint32 numSamples,
+                      DecimationAccumulator& accumulator)
+{
+	accumulator.min = accumulator.numSamples ? std::min (accumulator.min, min) : min;
+	accumulator.max = accumulator.numSamples ? std::max (accumulator.max, max) : max;
+	accumulator.sumOfSquares += sumOfSquares;
+	accumulator.numSamples += numSamples;
+}
+
+//------------------------------------------------------------------------
+void accumulateStrided (const float* samples, uint32 numSamples, uint32 stride,
+                        DecimationAccumulator& accumulator)
+{
+	for (auto index = 0u; index < numSamples; ++index)
+	{
+		auto sample = samples[index * stride];
+		addPoint (sample, sample, sample * sample, 1, accumulator);
+	}
+}
+
+//------------------------------------------------------------------------
+void accumulateInt16 (const int16_t* samples, uint32 numSamples, DecimationAccumulator& accumulator)
+{
+	constexpr auto kScale = 1.f / 32767.f;
+	for (auto index = 0u; index < numSamples; ++index)
+	{
+		auto sample = samples[index] * kScale;
+		addPoint (sample, sample, sample * sample, 1, accumulator);
+	}
+}
+
+//------------------------------------------------------------------------
+void accumulatePoints (const DecimatedPoint* points, uint32 numPoints, uint32 decimation,
+                       DecimationAccumulator& accumulator)
+{
+	for (auto index = 0u; index < numPoints; ++index)
+	{
+		const auto& point = points[index];
+		addPoint (point.min, point.max, point.rms * point.rms * decimation, decimation,
+		          accumulator);
+	}
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+BlockAnalyzer::~BlockAnalyzer () noexcept
+{
+	stop ();
+}
+
+//------------------------------------------------------------------------
+void BlockAnalyzer::start (uint32 blockSize, uint32 numSlots)
+{
+	stop ();
+	ring.setup (blockSize, numSlots);
+	blocksLost = 0;
+	current = {};
+	samplesAnalyzed = 0;
+	loudness = {};
+	spectrum = {};
+	// allocates the chunks with the first block, when the channel count is known
+	overview.reset (overviewConfig, 0);
+	scratch.assign (blockSize / sizeof (int16_t), 0.f);
+	mono.assign (blockSize / sizeof (int16_t), 0.f);
+	for (auto& accumulator : accumulators)
+		accumulator.reset ();
+	running = true;
+	worker = std::thread ([this] () { run (); });
+}
+
+//------------------------------------------------------------------------
+void BlockAnalyzer::stop ()
+{
+	if (!worker.joinable ())
+		return;
+	{
+		std::lock_guard<std::mutex> lock (wakeUpMutex);
+		running = false;
+	}
+	wakeUp.notify_one ();
+	worker.join ();
+}
+
+//------------------------------------------------------------------------
+void BlockAnalyzer::push (const DataBlock* block, uint32 blockSize)
+{
+	if (!ring.push (block, blockSize))
+	{
+		blocksLost.fetch_add (1, std::memory_order_relaxed);
+		return;
+	}
+	// a notification racing with the worker going to sleep only delays it until the timeout
+	wakeUp.notify_one ();
+}
+
+//------------------------------------------------------------------------
+void BlockAnalyzer::run ()
+{
+	constexpr auto kTimeout = std::chrono::milliseconds (1000 / kResultRate);
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock (wakeUpMutex);
+			wakeUp.wait_for (lock, kTimeout, [this] () { return !running || !ring.empty (); });
+			if (!running)
+				break;
+		}
+		ring.popAll ([this] (const void* block) {
+			analyze (static_cast<const DataBlock*> (block));
+		});
+	}
+}
+
+//------------------------------------------------------------------------
+void BlockAnalyzer::analyze (const DataBlock* block)
+{
+	auto numChannels = std::min<uint32> (block->numChannels, kMaxAnalyzedChannels);
+	for (auto channel = 0u; channel < numChannels; ++channel)
+	{
+		auto& accumulator = accumulators[channel];
+		switch (block->payloadFormat)
+		{
+			case PayloadFormat::Planar:
+			{
+				accumulate (getChannelSamples (block, channel), block->numSamples, accumulator);
+				break;
+			}
+			case PayloadFormat::Interleaved:
+			{
+				accumulateStrided (getChannelSamples (block, channel), block->numSamples,
+				                   block->frameStride, accumulator);
+				break;
+			}
+			case PayloadFormat::Int16:
+			{
+				accumulateInt16 (getChannelData<int16_t> (block, channel), block->numSamples,
+				                 accumulator);
+				break;
+			}
+			case PayloadFormat::Decimated:
+			{
+				auto points = getChannelData<DecimatedPoint> (block, channel);
+				accumulatePoints (points, block->numSamples, block->decimation, accumulator);
+				break;
+			}
+			case PayloadFormat::Stereo:
+			{
+				// no levels per channel, the controller shows them on the stereo meter
+				break;
+			}
+		}
+	}
+	if (block->payloadFormat != PayloadFormat::Decimated &&
+	    block->payloadFormat != PayloadFormat::Stereo)
+		analyzeAudio (block, numChannels);
+	if (block->payloadFormat != PayloadFormat::Stereo)
+	{
+		if (overview.getNumChannels () != block->numChannels)
+			overview.reset (overviewConfig, block->numChannels);
+		overview.append (block);
+	}
+
+	current.sampleRate = block->sampleRate;
+	current.numChannels = numChannels;
+	current.samplePosition =
+	    block->samplePosition + static_cast<uint64> (block->numSamples) * block->decimation;
+	current.blocksDropped = block->blocksDropped;
+	current.samplesDropped = block->samplesDropped;
+	++current.blocksAnalyzed;
+	sampleRate = block->sampleRate;
+	samplesAnalyzed += static_cast<uint64> (block->numSamples) * block->decimation;
+	if (samplesAnalyzed * kResultRate >= sampleRate)
+		publish ();
+}
+
+//------------------------------------------------------------------------
+void BlockAnalyzer::analyzeAudio (const DataBlock* block, uint32 numChannels)
+{
+	if (loudness.getSampleRate () != block->sampleRate || loudness.getNumChannels () != numChannels)
+		loudness.setup (block->sampleRate, numChannels);
+	if (spectrum.getSampleRate () != block->sampleRate)
+		spectrum.setup (block->sampleRate, spectrumConfig);
+	if (numChannels == 0 || static_cast<uint64> (numChannels) * block->numSamples > scratch.size ())
+		return;
+
+	std::array<const float*, kMaxAnalyzedChannels> channels;
+	for (auto channel = 0u; channel < numChannels; ++channel)
+	{
+		auto planar = scratch.data () + channel * block->numSamples;
+		switch (block->payloadFormat)
+		{
+			case PayloadFormat::Interleaved:
+			{
+				auto samples = getChannelSamples (block, channel);
+				for (auto index = 0u; index < block->numSamples; ++index)
+					planar[index] = samples[index * block->frameStride];
+				channels[channel] = planar;
+				break;
+			}
+			case PayloadFormat::Int16:
+			{
+				auto samples = getChannelData<int16_t> (block, channel);
+				for (auto index = 0u; index < block->numSamples; ++index)
+					planar[index] = samples[index] * (1.f / 32767.f);
+				channels[channel] = planar;
+				break;
+			}
+			default:
+			{
+				channels[channel] = getChannelSamples (block, channel);
+				break;
+			}
+		}
+	}
+	loudness.process (channels.data (), block->numSamples);
+
+	if (spectrum.getSampleRate () == 0.)
+		return;
+	auto gain = 1.f / numChannels;
+	for (auto index = 0u; index < block->numSamples; ++index)
+		mono[index] = channels[0][index] * gain;
+	for (auto channel = 1u; channel < numChannels; ++channel)
+	{
+		for (auto index = 0u; index < block->numSamples; ++index)
+			mono[index] += channels[channel][index] * gain;
+	}
+	spectrum.process (mono.data (), block->numSamples);
+}
+
+//------------------------------------------------------------------------
+void BlockAnalyzer::publish ()
+{
+	for (auto channel = 0u; channel < current.numChannels; ++channel)
+	{
+		auto& accumulator = accumulators[channel];
+		auto point = accumulator.getPoint ();
+		current.peak[channel] = std::max (-point.min, point.max);
+		current.rms[channel] = point.rms;
+		current.truePeak[channel] = loudness.takeTruePeak (channel);
+		accumulator.reset ();
+	}
+	current.momentaryLoudness = loudness.getMomentaryLoudness ();
+	current.shortTermLoudness = loudness.getShortTermLoudness ();
+	current.integratedLoudness = loudness.getIntegratedLoudness ();
+	current.maxTruePeak = loudness.getMaxTruePeak ();
+	current.hasSpectrum = spectrum.takeSpectrum (current.spectrum.data ());
+	overview.getPositions (current.overviewBegin, current.overviewEnd);
+	current.hasOverview = overview.render (0, current.overviewBegin, current.overviewEnd,
+	                                       current.overview.data (), kOverviewPixels);
+	current.overviewMemorySize = overview.getMemorySize ();
+	current.blocksLost = blocksLost.load (std::memory_order_relaxed);
+	results.write (current);
+	samplesAnalyzed = 0;
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "blockring.h"
+#include "dataexchange.h"
+#include "loudness.h"
+#include "payloadkernels.h"
+#include "spectrum.h"
+#include "triplebuffer.h"
+#include "waveformoverview.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+static constexpr uint32 kMaxAnalyzedChannels = 64;
+static constexpr uint32 kOverviewPixels = 512;
+
+//------------------------------------------------------------------------
+/** Levels of the audio received since the previous result. */
+struct AnalysisResult
+{
+	// position after the last analyzed sample
+	uint64 samplePosition {0};
+	uint32 sampleRate {0};
+	uint32 numChannels {0};
+	std::array<float, kMaxAnalyzedChannels> peak {};
+	std::array<float, kMaxAnalyzedChannels> rms {};
+	std::array<float, kMaxAnalyzedChannels> truePeak {};
+
+	// in LUFS, not measured for PayloadFormat::Decimated
+	double momentaryLoudness {LoudnessMeter::kSilence};
+	double shortTermLoudness {LoudnessMeter::kSilence};
+	double integratedLoudness {LoudnessMeter::kSilence};
+	// largest true peak since the start, linear
+	float maxTruePeak {0.f};
+
+	// of the mono sum, not measured for PayloadFormat::Decimated
+	bool hasSpectrum {false};
+	std::array<float, SpectrumAnalyzer::kNumDisplayBins> spectrum {};
+
+	// the kept window of the waveform overview of the first channel, one range per pixel
+	bool hasOverview {false};
+	uint64 overviewBegin {0};
+	uint64 overviewEnd {0};
+	uint64 overviewMemorySize {0};
+	std::array<WaveformRange, kOverviewPixels> overview {};
+
+	uint32 blocksAnalyzed {0};
+	// blocks which did not fit into the ring of the analyzer
+	uint32 blocksLost {0};
+	// counters of the processor
+	uint32 blocksDropped {0};
+	uint64 samplesDropped {0};
+};
+
+//------------------------------------------------------------------------
+/** Measures the levels, the loudness and the spectrum of received data blocks on a worker thread
+ *	and keeps their waveform overview.
+ *
+ *	The thread receiving the blocks only copies them into a lock-free ring and wakes the worker. The
+ *	worker processes all queued blocks at once and publishes a result whenever it has analyzed
+ *	1 / kResultRate seconds of audio, the UI thread picks up the latest one with a timer. */
+class BlockAnalyzer
+{
+public:
+	static constexpr uint32 kResultRate = 30;
+
+	~BlockAnalyzer () noexcept;
+
+	/** Takes effect with the next start. */
+	void setSpectrumConfig (const SpectrumConfig& config) { spectrumConfig = config; }
+	/** Takes effect with the next start. */
+	void setOverviewConfig (const OverviewConfig& config) { overviewConfig = config; }
+
+	/** Starts the worker with a ring of numSlots blocks. Not thread safe. */
+	void start (uint32 blockSize, uint32 numSlots);
+	/** Stops the worker, queued blocks are discarded. Not thread safe. */
+	void stop ();
+
+	/** Copies the block into the ring, called by the thread which receives the blocks. */
+	void push (const DataBlock* block, uint32 blockSize);
+	/** Returns false if there is no new result, called by the UI thread. */
+	bool getLatestResult (AnalysisResult& result) { return results.read (result); }
+
+//------------------------------------------------------------------------
+private:
+	void run ();
+	void analyze (const DataBlock* block);
+	void analyzeAudio (const DataBlock* block, uint32 numChannels);
+	void publish ();
+
+	BlockRing ring;
+	std::thread worker;
+	std::atomic<bool> running {false};
+	std::mutex wakeUpMutex;
+	std::condition_variable wakeUp;
+	std::atomic<uint32> blocksLost {0};
+
+	// owned by the worker
+	std::array<DecimationAccumulator, kMaxAnalyzedChannels> accumulators {};
+	AnalysisResult current;
+	uint64 samplesAnalyzed {0};
+	uint32 sampleRate {0};
+	LoudnessMeter loudness;
+	SpectrumAnalyzer spectrum;
+	SpectrumConfig spectrumConfig;
+	WaveformOverview overview;
+	OverviewConfig overviewConfig;
+	// planar float copy of interleaved and int16 blocks, and the mono sum
+	std::vector<float> scratch;
+	std::vector<float> mono;
+
+	TripleBuffer<AnalysisResult> results;
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,552 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "blockrecorder.h"
+#include "payloadkernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if defined(__linux__) || defined(__APPLE__)
+#define TUTORIAL_RECORDER_POSIX 1
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#define TUTORIAL_RECORDER_POSIX 0
+#endif
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+//------------------------------------------------------------------------
+// Sony Wave64: every chunk starts with a GUID and a 64 bit size which includes the 24 byte chunk
+// header. The header is padded with a junk chunk, so the samples start at kWriteAlignment.
+//------------------------------------------------------------------------
+using Guid = uint8[16];
+
+constexpr Guid kRiffGuid = {0x72, 0x69, 0x66, 0x66, 0x2E, 0x91, 0xCF, 0x11,
+                            0xA5, 0xD6, 0x28, 0xDB, 0x04, 0xC1, 0x00, 0x00};
+constexpr Guid kWaveGuid = {0x77, 0x61, 0x76, 0x65, 0xF3, 0xAC, 0xD3, 0x11,
+                            0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+constexpr Guid kFormatGuid = {0x66, 0x6D, 0x74, 0x20, 0xF3, 0xAC, 0xD3, 0x11,
+                              0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+constexpr Guid kJunkGuid = {0x6A, 0x75, 0x6E, 0x6B, 0xF3, 0xAC, 0xD3, 0x11,
+                            0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+constexpr Guid kDataGuid = {0x64, 0x61, 0x74, 0x61, 0xF3, 0xAC, 0xD3, 0x11,
+                            0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+constexpr Guid kFloatSubFormat = {0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+                                  0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+constexpr Guid kPCMSubFormat = {0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+                                0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+
+constexpr uint32 kChunkHeaderSize = 24;
+constexpr uint32 kFormatChunkOffset = 40;
+constexpr uint32 kFormatChunkSize = kChunkHeaderSize + 40;
+constexpr uint32 kJunkChunkOffset = kFormatChunkOffset + kFormatChunkSize;
+constexpr uint32 kDataChunkOffset = BlockRecorder::kWriteAlignment - kChunkHeaderSize;
+
+//------------------------------------------------------------------------
+/** Stores little endian, like all platforms of the SDK. */
+template <typename T>
+inline void writeValue (uint8* header, uint32 offset, T value)
+{
+	std::memcpy (header + offset, &value, sizeof (T));
+}
+
+//------------------------------------------------------------------------
+inline void writeChunkHeader (uint8* header, uint32 offset, const Guid& guid, uint64 size)
+{
+	std::memcpy (header + offset, guid, sizeof (Guid));
+	writeValue (header, offset + sizeof (Guid), size);
+}
+
+//------------------------------------------------------------------------
+/** Writes the kWriteAlignment bytes in front of the samples, fileSize 0 while recording. */
+void writeWave64Header (uint8* header, uint32 sampleRate, uint16 numChannels, bool isFloat,
+                        uint64 fileSize, uint64 dataSize)
+{
+	std::memset (header, 0, BlockRecorder::kWriteAlignment);
+	writeChunkHeader (header, 0, kRiffGuid, fileSize);
+	std::memcpy (header + kChunkHeaderSize, kWaveGuid, sizeof (Guid));
+
+	// WAVEFORMATEXTENSIBLE
+	uint16 bitsPerSample = isFloat ? 32 : 16;
+	uint16 blockAlign = numChannels * bitsPerSample / 8;
+	auto format = kFormatChunkOffset + kChunkHeaderSize;
+	writeChunkHeader (header, kFormatChunkOffset, kFormatGuid, kFormatChunkSize);
+	writeValue<uint16> (header, format, 0xFFFE);
+	writeValue<uint16> (header, format + 2, numChannels);
+	writeValue<uint32> (header, format + 4, sampleRate);
+	writeValue<uint32> (header, format + 8, sampleRate * blockAlign);
+	writeValue<uint16> (header, format + 12, blockAlign);
+	writeValue<uint16> (header, format + 14, bitsPerSample);
+	writeValue<uint16> (header, format + 16, 22);
+	writeValue<uint16> (header, format + 18, bitsPerSample);
+	writeValue<uint32> (header, format + 20, 0);
+	std::memcpy (header + format + 24, isFloat ? kFloatSubFormat : kPCMSubFormat, sizeof (Guid));
+
+	writeChunkHeader (header, kJunkChunkOffset, kJunkGuid, kDataChunkOffset - kJunkChunkOffset);
+	writeChunkHeader (header, kDataChunkOffset, kDataGuid, dataSize + kChunkHeaderSize);
+}
+
+//------------------------------------------------------------------------
+inline uint64 roundUp (uint64 value, uint64 alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+// RecordingFile
+//------------------------------------------------------------------------
+#if TUTORIAL_RECORDER_POSIX
+bool RecordingFile::open (const std::string& path, bool directIO)
+{
+	close ();
+	auto flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+	direct = false;
+#if defined(O_DIRECT)
+	if (directIO)
+	{
+		// not every file system supports it, tmpfs for example
+		descriptor = ::open (path.data (), flags | O_DIRECT, 0644);
+		direct = descriptor >= 0;
+	}
+#endif
+	if (descriptor < 0)
+		descriptor = ::open (path.data (), flags, 0644);
+#if defined(F_NOCACHE)
+	if (descriptor >= 0 && directIO)
+		fcntl (descriptor, F_NOCACHE, 1);
+#endif
+	return descriptor >= 0;
+}
+
+//------------------------------------------------------------------------
+void RecordingFile::close ()
+{
+	if (descriptor >= 0)
+		::close (descriptor);
+	descriptor = -1;
+}
+
+//------------------------------------------------------------------------
+bool RecordingFile::write (const void* data, size_t size)
+{
+	auto bytes = static_cast<const uint8*> (data);
+	while (size > 0)
+	{
+		auto result = ::write (descriptor, bytes, size);
+		if (result < 0 && errno == EINTR)
+			continue;
+		if (result <= 0)
+			return false;
+		bytes += result;
+		size -= static_cast<size_t> (result);
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool RecordingFile::writeAt (uint64 offset, const void* data, size_t size)
+{
+	auto bytes = static_cast<const uint8*> (data);
+	while (size > 0)
+	{
+		auto result = ::pwrite (descriptor, bytes, size, static_cast<off_t> (offset));
+		if (result < 0 && errno == EINTR)
+			continue;
+		if (result <= 0)
+			return false;
+		bytes += result;
+		offset += static_cast<uint64> (result);
+		size -= static_cast<size_t> (result);
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool RecordingFile::truncate (uint64 size)
+{
+	return ::ftruncate (descriptor, static_cast<off_t> (size)) == 0;
+}
+
+//------------------------------------------------------------------------
+bool RecordingFile::sync ()
+{
+#if defined(__APPLE__)
+	return ::fsync (descriptor) == 0;
+#else
+	return ::fdatasync (descriptor) == 0;
+#endif
+}
+
+//------------------------------------------------------------------------
+bool RecordingFile::isOpen () const
+{
+	return descriptor >= 0;
+}
+
+#else
+//------------------------------------------------------------------------
+bool RecordingFile::open (const std::string& path, bool /*directIO*/)
+{
+	close ();
+	direct = false;
+	stream = std::fopen (path.data (), "wb");
+	return stream != nullptr;
+}
+
+//------------------------------------------------------------------------
+void RecordingFile::close ()
+{
+	if (stream)
+		std::fclose (stream);
+	stream = nullptr;
+}
+
+//------------------------------------------------------------------------
+bool RecordingFile::write (const void* data, size_t size)
+{
+	return std::fwrite (data, 1, size, stream) == size;
+}
+
+//------------------------------------------------------------------------
+bool RecordingFile::writeAt (uint64 offset, const void* data, size_t size)
+{
+	// only used for the header, at an offset below 2 GB
+	if (std::fseek (stream, static_cast<long> (offset), SEEK_SET) != 0)
+		return false;
+	auto result = std::fwrite (data, 1, size, stream) == size;
+	return std::fseek (stream, 0, SEEK_END) == 0 && result;
+}
+
+//------------------------------------------------------------------------
+bool RecordingFile::truncate (uint64 /*size*/)
+{
+	// only needed after padded direct writes
+	return false;
+}
+
+//------------------------------------------------------------------------
+bool RecordingFile::sync ()
+{
+	return std::fflush (stream) == 0;
+}
+
+//------------------------------------------------------------------------
+bool RecordingFile::isOpen () const
+{
+	return stream != nullptr;
+}
+#endif // TUTORIAL_RECORDER_POSIX
+
+//------------------------------------------------------------------------
+// BlockRecorder
+//------------------------------------------------------------------------
+BlockRecorder::~BlockRecorder () noexcept
+{
+	stop ();
+}
+
+//------------------------------------------------------------------------
+bool BlockRecorder::start (const std::string& path, const RecorderConfig& recorderConfig,
+                           uint32 blockSize)
+{
+	stop ();
+	config = recorderConfig;
+	if (!file.open (path, config.directIO))
+		return false;
+
+	// two blocks and the header always fit, so every block can be recorded once the writer is idle
+	auto minimumSize = static_cast<uint64> (blockSize) + kWriteAlignment;
+	bufferSize = roundUp (std::max<uint64> (config.writeBufferSize, minimumSize), kWriteAlignment);
+	for (auto& buffer : buffers)
+	{
+		buffer.pages.resize (bufferSize / kWriteAlignment);
+		buffer.full = false;
+	}
+	scratch.resize ((blockSize + kDataBlockAlignment - 1) / kDataBlockAlignment);
+	channelPointers.clear ();
+	fillIndex = 0;
+	fillSize = 0;
+	fileStarted = false;
+	pendingSilence = 0;
+	writeIndex = 0;
+	bytesSinceSync = 0;
+	bytesWritten = 0;
+	blocksRecorded = 0;
+	blocksLost = 0;
+	blocksSkipped = 0;
+	samplesMissing = 0;
+	writeFailed = false;
+
+	running = true;
+	writer = std::thread ([this] () { run (); });
+	return true;
+}
+
+//------------------------------------------------------------------------
+void BlockRecorder::stop ()
+{
+	if (!writer.joinable ())
+		return;
+	{
+		std::lock_guard<std::mutex> lock (wakeUpMutex);
+		running = false;
+	}
+	wakeUp.notify_one ();
+	writer.join ();
+	finishFile ();
+	file.close ();
+}
+
+//------------------------------------------------------------------------
+RecorderStatistics BlockRecorder::getStatistics () const
+{
+	RecorderStatistics statistics;
+	statistics.bytesWritten = bytesWritten.load (std::memory_order_relaxed);
+	statistics.blocksRecorded = blocksRecorded.load (std::memory_order_relaxed);
+	statistics.blocksLost = blocksLost.load (std::memory_order_relaxed);
+	statistics.blocksSkipped = blocksSkipped.load (std::memory_order_relaxed);
+	statistics.samplesMissing = samplesMissing.load (std::memory_order_relaxed);
+	statistics.writeFailed = writeFailed.load (std::memory_order_relaxed);
+	return statistics;
+}
+
+//------------------------------------------------------------------------
+void BlockRecorder::push (const DataBlock* block, uint32 blockSize)
+{
+	if (!running.load (std::memory_order_relaxed) || writeFailed.load (std::memory_order_relaxed))
+		return;
+
+	if (config.format == RecordingFormat::RawBlocks)
+	{
+		if (getAvailableSpace () < blockSize)
+			blocksLost.fetch_add (1, std::memory_order_relaxed);
+		else
+		{
+			append (block, blockSize);
+			blocksRecorded.fetch_add (1, std::memory_order_relaxed);
+		}
+		return;
+	}
+
+	if (block->payloadFormat == PayloadFormat::Decimated ||
+	    block->payloadFormat == PayloadFormat::Stereo)
+	{
+		blocksSkipped.fetch_add (1, std::memory_order_relaxed);
+		return;
+	}
+	if (!fileStarted)
+		beginFile (block);
+	if (block->sampleRate != sampleRate || block->numChannels != numChannels ||
+	    (block->payloadFormat == PayloadFormat::Int16) != isInt16)
+	{
+		blocksSkipped.fetch_add (1, std::memory_order_relaxed);
+		return;
+	}
+
+	// keep the timeline: samples missing in front of the block are recorded as silence
+	if (block->samplePosition > nextPosition)
+		pendingSilence += block->samplePosition - nextPosition;
+	nextPosition = block->samplePosition + block->numSamples;
+	if (pendingSilence > 0)
+	{
+		auto numFrames = std::min<uint64> (pendingSilence, getAvailableSpace () / bytesPerFrame);
+		append (nullptr, numFrames * bytesPerFrame);
+		pendingSilence -= numFrames;
+		samplesMissing.fetch_add (numFrames, std::memory_order_relaxed);
+	}
+	if (pendingSilence > 0 ||
+	    getAvailableSpace () < static_cast<size_t> (block->numSamples) * bytesPerFrame)
+	{
+		pendingSilence += block->numSamples;
+		blocksLost.fetch_add (1, std::memory_order_relaxed);
+		return;
+	}
+	appendAudio (block);
+	blocksRecorded.fetch_add (1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------
+void BlockRecorder::beginFile (const DataBlock* block)
+{
+	fileStarted = true;
+	sampleRate = block->sampleRate;
+	numChannels = block->numChannels;
+	isInt16 = block->payloadFormat == PayloadFormat::Int16;
+	bytesPerFrame = numChannels * (isInt16 ? sizeof (int16_t) : sizeof (float));
+	nextPosition = block->samplePosition;
+	channelPointers.resize (numChannels);
+
+	// the first buffer is empty, the sizes are completed by stop
+	writeWave64Header (buffers[fillIndex].data (), sampleRate, numChannels, !isInt16, 0, 0);
+	fillSize = kWriteAlignment;
+}
+
+//------------------------------------------------------------------------
+void BlockRecorder::appendAudio (const DataBlock* block)
+{
+	auto numSamples = block->numSamples;
+	auto size = static_cast<size_t> (numSamples) * bytesPerFrame;
+	if (block->payloadFormat == PayloadFormat::Interleaved || numChannels == 1)
+	{
+		append (block->samples, size);
+		return;
+	}
+
+	// interleave straight into the write buffer unless the block continues in the next one
+	auto isContiguous = bufferSize - fillSize >= size;
+	auto interleaved = scratch.data ()->bytes;
+	if (isContiguous)
+		interleaved = buffers[fillIndex].data () + fillSize;
+	if (block->payloadFormat == PayloadFormat::Int16)
+	{
+		auto output = reinterpret_cast<int16_t*> (interleaved);
+		for (auto channel = 0u; channel < numChannels; ++channel)
+		{
+			auto input = getChannelData<int16_t> (block, channel);
+			for (auto frame = 0u; frame < numSamples; ++frame)
+				output[frame * numChannels + channel] = input[frame];
+		}
+	}
+	else
+	{
+		for (auto channel = 0u; channel < numChannels; ++channel)
+			channelPointers[channel] = getChannelSamples (block, channel);
+		interleaveChannels (channelPointers.data (), numChannels, numSamples,
+		                    reinterpret_cast<float*> (interleaved));
+	}
+	if (!isContiguous)
+		append (interleaved, size);
+	else if ((fillSize += size) == bufferSize)
+		handOver ();
+}
+
+//------------------------------------------------------------------------
+size_t BlockRecorder::getAvailableSpace () const
+{
+	// after a hand over the fill buffer may still be written by the writer
+	if (buffers[fillIndex].full.load (std::memory_order_acquire))
+		return 0;
+	auto space = bufferSize - fillSize;
+	if (!buffers[fillIndex ^ 1].full.load (std::memory_order_acquire))
+		space += bufferSize;
+	return space;
+}
+
+//------------------------------------------------------------------------
+void BlockRecorder::append (const void* data, size_t size)
+{
+	auto bytes = static_cast<const uint8*> (data);
+	while (size > 0)
+	{
+		auto count = std::min (size, bufferSize - fillSize);
+		auto destination = buffers[fillIndex].data () + fillSize;
+		if (bytes)
+		{
+			std::memcpy (destination, bytes, count);
+			bytes += count;
+		}
+		else
+			std::memset (destination, 0, count);
+		fillSize += count;
+		size -= count;
+		if (fillSize == bufferSize)
+			handOver ();
+	}
+}
+
+//------------------------------------------------------------------------
+void BlockRecorder::handOver ()
+{
+	buffers[fillIndex].full.store (true, std::memory_order_release);
+	// a notification racing with the writer going to sleep only delays it until the timeout
+	wakeUp.notify_one ();
+	fillIndex ^= 1;
+	fillSize = 0;
+}
+
+//------------------------------------------------------------------------
+void BlockRecorder::run ()
+{
+	constexpr auto kTimeout = std::chrono::milliseconds (20);
+	while (true)
+	{
+		auto& buffer = buffers[writeIndex];
+		{
+			std::unique_lock<std::mutex> lock (wakeUpMutex);
+			wakeUp.wait_for (lock, kTimeout, [&] () {
+				return !running || buffer.full.load (std::memory_order_acquire);
+			});
+		}
+		// the buffers are written in the order they were filled, nothing is left if this one is
+		// not full once stopped
+		if (!buffer.full.load (std::memory_order_acquire))
+		{
+			if (!running)
+				break;
+			continue;
+		}
+		writeBuffer (buffer.data (), bufferSize);
+		buffer.full.store (false, std::memory_order_release);
+		writeIndex ^= 1;
+	}
+}
+
+//------------------------------------------------------------------------
+void BlockRecorder::writeBuffer (const uint8* data, size_t size)
+{
+	if (!writeFailed.load (std::memory_order_relaxed) && !file.write (data, size))
+		writeFailed.store (true, std::memory_order_relaxed);
+	bytesWritten.fetch_add (size, std::memory_order_relaxed);
+
+	// batch the syncs, every sync waits for the device
+	bytesSinceSync += size;
+	if (config.syncInterval > 0 && bytesSinceSync >= config.syncInterval)
+	{
+		file.sync ();
+		bytesSinceSync = 0;
+	}
+}
+
+//------------------------------------------------------------------------
+void BlockRecorder::finishFile ()
+{
+	// the writer has stopped, the fill buffer holds the rest
+	auto written = bytesWritten.load (std::memory_order_relaxed);
+	auto isWave64 = config.format == RecordingFormat::Wave64;
+	auto dataEnd = written + fillSize;
+	// Wave64 chunks are padded to 8 bytes
+	auto fileSize = isWave64 ? roundUp (dataEnd, 8) : dataEnd;
+	auto tailSize = static_cast<size_t> (fileSize - written);
+	if (tailSize > 0)
+	{
+		auto tail = buffers[fillIndex].data ();
+		auto writeSize = file.isDirect () ? roundUp (tailSize, kWriteAlignment) : tailSize;
+		std::memset (tail + fillSize, 0, writeSize - fillSize);
+		writeBuffer (tail, writeSize);
+		if (writeSize != tailSize && !file.truncate (fileSize))
+			writeFailed = true;
+		bytesWritten = fileSize;
+	}
+
+	if (isWave64 && fileStarted)
+	{
+		auto header = buffers[fillIndex ^ 1].data ();
+		writeWave64Header (header, sampleRate, numChannels, !isInt16, fileSize,
+		                   dataEnd - kWriteAlignment);
+		if (!file.writeAt (0, header, kWriteAlignment))
+			writeFailed = true;
+	}
+	file.sync ();
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
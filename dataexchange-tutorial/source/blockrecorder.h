@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "dataexchange.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+enum class RecordingFormat : uint16
+{
+	// Sony Wave64 with the audio as interleaved float or int16, 64 bit sizes
+	Wave64,
+	// every DataBlock as received, including its header, blockSize bytes per block
+	RawBlocks,
+};
+
+//------------------------------------------------------------------------
+struct RecorderConfig
+{
+	RecordingFormat format {RecordingFormat::Wave64};
+	// size of each of the two write buffers, rounded up to BlockRecorder::kWriteAlignment
+	uint32 writeBufferSize {8 * 1024 * 1024};
+	// bytes written between two fdatasync calls, 0 to only sync when the recording stops
+	uint64 syncInterval {64 * 1024 * 1024};
+	// bypass the page cache: O_DIRECT on Linux, F_NOCACHE on macOS
+	bool directIO {true};
+};
+
+//------------------------------------------------------------------------
+struct RecorderStatistics
+{
+	uint64 bytesWritten {0};
+	uint32 blocksRecorded {0};
+	// blocks which did not fit into the write buffers, recorded as silence in Wave64 files
+	uint32 blocksLost {0};
+	// blocks which cannot be stored in the file: decimated payload or another channel count or
+	// sample rate than the first block (Wave64 only)
+	uint32 blocksSkipped {0};
+	// silence written for samples the processor dropped or the recorder lost
+	uint64 samplesMissing {0};
+	bool writeFailed {false};
+};
+
+//------------------------------------------------------------------------
+/** File for sequential writes of whole write buffers. */
+class RecordingFile
+{
+public:
+	~RecordingFile () noexcept { close (); }
+
+	/** Creates or truncates the file. Falls back to buffered I/O if directIO is not supported. */
+	bool open (const std::string& path, bool directIO);
+	void close ();
+
+	/** With direct I/O data, size and the file position must be multiples of kWriteAlignment. */
+	bool write (const void* data, size_t size);
+	bool writeAt (uint64 offset, const void* data, size_t size);
+	bool truncate (uint64 size);
+	bool sync ();
+
+	bool isOpen () const;
+	bool isDirect () const { return direct; }
+
+//------------------------------------------------------------------------
+private:
+	int descriptor {-1};
+	std::FILE* stream {nullptr};
+	bool direct {false};
+};
+
+//------------------------------------------------------------------------
+/** Records received data blocks to disk without blocking the thread which receives them.
+ *
+ *	The receiving thread converts every block into the current of two preallocated write buffers.
+ *	A full buffer is handed to the writer thread and the other one is filled meanwhile, a block
+ *	which does not fit because the writer still writes the other buffer is lost. The writer syncs
+ *	the file every RecorderConfig::syncInterval bytes; the header is completed by stop. */
+class BlockRecorder
+{
+public:
+	static constexpr uint32 kWriteAlignment = 4096;
+
+	~BlockRecorder () noexcept;
+
+	/** Creates the file and starts the writer. Returns false if the file cannot be created. Not
+	 *	thread safe. */
+	bool start (const std::string& path, const RecorderConfig& config, uint32 blockSize);
+	/** Writes the buffered data, completes the header and closes the file. Not thread safe. */
+	void stop ();
+	bool isRecording () const { return file.isOpen (); }
+
+	/** Converts the block into the write buffer, called by the thread which receives the blocks. */
+	void push (const DataBlock* block, uint32 blockSize);
+
+	/** Can be called from any thread. */
+	RecorderStatistics getStatistics () const;
+
+//------------------------------------------------------------------------
+private:
+	struct alignas (kWriteAlignment) Page
+	{
+		uint8 bytes[kWriteAlignment];
+	};
+
+	struct WriteBuffer
+	{
+		std::vector<Page> pages;
+		// set by the receiving thread when the buffer is full, cleared by the writer
+		std::atomic<bool> full {false};
+
+		uint8* data () { return pages.data ()->bytes; }
+	};
+
+	void run ();
+	void beginFile (const DataBlock* block);
+	void appendAudio (const DataBlock* block);
+	size_t getAvailableSpace () const;
+	/** A nullptr writes zeros. */
+	void append (const void* data, size_t size);
+	void handOver ();
+	void writeBuffer (const uint8* data, size_t size);
+	void finishFile ();
+
+	RecorderConfig config;
+	RecordingFile file;
+	std::array<WriteBuffer, 2> buffers;
+	size_t bufferSize {0};
+	std::thread writer;
+	std::atomic<bool> running {false};
+	std::mutex wakeUpMutex;
+	std::condition_variable wakeUp;
+
+	// owned by the receiving thread
+	uint32 fillIndex {0};
+	size_t fillSize {0};
+	bool fileStarted {false};
+	uint32 sampleRate {0};
+	uint16 numChannels {0};
+	bool isInt16 {false};
+	uint32 bytesPerFrame {0};
+	uint64 nextPosition {0};
+	uint64 pendingSilence {0};
+	// interleaved copy of a planar block
+	std::vector<DataBlockStorage> scratch;
+	std::vector<const float*> channelPointers;
+
+	// owned by the writer
+	uint32 writeIndex {0};
+	uint64 bytesSinceSync {0};
+
+	std::atomic<uint64> bytesWritten {0};
+	std::atomic<uint32> blocksRecorded {0};
+	std::atomic<uint32> blocksLost {0};
+	std::atomic<uint32> blocksSkipped {0};
+	std::atomic<uint64> samplesMissing {0};
+	std::atomic<bool> writeFailed {false};
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/base/ftypes.h"
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+/** Lock-free single producer single consumer ring of fixed size byte blocks.
+ *
+ *	The memory is allocated by setup, push and pop neither allocate nor lock. The producer copies a
+ *	block into the next free slot; the consumer reads the oldest slots in place and releases them
+ *	afterwards. */
+class BlockRing
+{
+public:
+	/** Not thread safe, call while neither producer nor consumer use the ring. */
+	void setup (uint32 blockSize, uint32 numSlots)
+	{
+		slotSize = (blockSize + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+		capacity = 1;
+		while (capacity < numSlots)
+			capacity <<= 1;
+		memory.assign (static_cast<size_t> (slotSize) * capacity / kSlotAlignment, {});
+		head.store (0, std::memory_order_relaxed);
+		tail.store (0, std::memory_order_relaxed);
+	}
+
+	uint32 getBlockSize () const { return slotSize; }
+
+	/** Producer: copies the block, returns false if the ring is full. */
+	bool push (const void* block, uint32 size)
+	{
+		auto writeIndex = head.load (std::memory_order_relaxed);
+		if (writeIndex - tail.load (std::memory_order_acquire) == capacity || size > slotSize)
+			return false;
+		std::memcpy (getSlot (writeIndex), block, size);
+		head.store (writeIndex + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Consumer: calls proc (const void* block) for every queued block and releases them. Returns
+	 *	the number of blocks. */
+	template <typename Proc>
+	uint32 popAll (Proc proc)
+	{
+		auto readIndex = tail.load (std::memory_order_relaxed);
+		auto writeIndex = head.load (std::memory_order_acquire);
+		for (auto index = readIndex; index != writeIndex; ++index)
+			proc (static_cast<const void*> (getSlot (index)));
+		tail.store (writeIndex, std::memory_order_release);
+		return writeIndex - readIndex;
+	}
+
+	bool empty () const
+	{
+		return head.load (std::memory_order_acquire) == tail.load (std::memory_order_acquire);
+	}
+
+//------------------------------------------------------------------------
+private:
+	static constexpr uint32 kSlotAlignment = 64;
+
+	// slots start on a cache line
+	struct alignas (kSlotAlignment) CacheLine
+	{
+		uint8 bytes[kSlotAlignment];
+	};
+
+	uint8* getSlot (uint32 index)
+	{
+		auto bytes = memory.data ()->bytes;
+		return bytes + static_cast<size_t> (index & (capacity - 1)) * slotSize;
+	}
+
+	std::vector<CacheLine> memory;
+	uint32 slotSize {0};
+	uint32 capacity {0};
+	alignas (64) std::atomic<uint32> head {0};
+	alignas (64) std::atomic<uint32> tail {0};
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
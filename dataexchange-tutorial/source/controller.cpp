@@ -4,15 +4,29 @@
 
 #include "cids.h"
 #include "controller.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 
 namespace Steinberg::Tutorial {
 
 //------------------------------------------------------------------------
 // DataExchangeController Implementation
+//------------------------------------------------------------------------
+tresult PLUGIN_API DataExchangeController::terminate ()
+{
+	sharedMemoryExchange.closeQueues ();
+	stopAnalysis ();
+	stopRecording ();
+	return EditControllerEx1::terminate ();
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API DataExchangeController::notify (Vst::IMessage* message)
 {
-	if (dataExchange.onMessage (message))
+	if (dataExchange.onMessage (message) || sharedMemoryExchange.onMessage (message))
 		return kResultTrue;
 	return EditControllerEx1::notify (message);
 }
@@ -22,13 +36,53 @@ void PLUGIN_API DataExchangeController::queueOpened (Vst::DataExchangeUserContex
                                                      uint32 blockSize,
                                                      TBool& dispatchOnBackgroundThread)
 {
-	FDebugPrint ("Data Exchange Queue opened.\n");
+	// the analysis, the waveform overview and the disk writes run on workers, the receiving
+	// thread only copies the blocks
+	dispatchOnBackgroundThread = true;
+	auto stream = getStream (userContextID);
+	if (!stream)
+	{
+		FDebugPrint ("Data Exchange Queue %u ignored.\n", userContextID);
+		return;
+	}
+	stream->isOpen = true;
+	stream->blockSize = blockSize;
+	stream->maxQueueDepth = 0;
+	stream->timing.reset (BlockAnalyzer::kResultRate);
+	stream->stereo = {};
+	stream->loggedBlocksMissing = 0;
+	stream->loggedTransportJumps = 0;
+	if (userContextID == kAnalyzedStream)
+	{
+		loggedBlocksDropped = 0;
+		loggedBlocksLost = 0;
+		loggedRecordingBlocksLost = 0;
+		loggedRecordingWriteFailed = false;
+		analyzer.start (blockSize, kAnalyzerRingSize);
+		startRecording (blockSize);
+	}
+	if (!displayTimer)
+		displayTimer = owned (Timer::create (this, 1000 / BlockAnalyzer::kResultRate));
+	FDebugPrint ("Data Exchange Queue %u opened.\n", userContextID);
 }
 
 //------------------------------------------------------------------------
 void PLUGIN_API DataExchangeController::queueClosed (Vst::DataExchangeUserContextID userContextID)
 {
-	FDebugPrint ("Data Exchange Queue closed.\n");
+	auto stream = getStream (userContextID);
+	if (!stream)
+		return;
+	stream->isOpen = false;
+	if (userContextID == kAnalyzedStream)
+	{
+		analyzer.stop ();
+		stopRecording ();
+	}
+	auto isOpen = [] (const ReceivedStream& entry) { return entry.isOpen; };
+	if (std::none_of (streams.begin (), streams.end (), isOpen))
+		stopAnalysis ();
+	FDebugPrint ("Data Exchange Queue %u closed. Max queue depth: %u\n", userContextID,
+	             stream->maxQueueDepth.load ());
 }
 
 //------------------------------------------------------------------------
@@ -36,15 +90,203 @@ void PLUGIN_API DataExchangeController::onDataExchangeBlocksReceived (
     Vst::DataExchangeUserContextID userContextID, uint32 numBlocks, Vst::DataExchangeBlock* blocks,
     TBool onBackgroundThread)
 {
+	auto receiveTime = getSteadyTime ();
+	auto stream = getStream (userContextID);
+	if (!stream)
+		return;
+	if (numBlocks > stream->maxQueueDepth.load (std::memory_order_relaxed))
+		stream->maxQueueDepth.store (numBlocks, std::memory_order_relaxed);
+	auto isAnalyzed = userContextID == kAnalyzedStream;
 	for (auto index = 0u; index < numBlocks; ++index)
 	{
-		auto dataBlock = toDataBlock (blocks[index]);
-		FDebugPrint (
-		    "Received Data Block: SampleRate: %d, SampleSize: %d, NumChannels: %d, NumSamples: %d\n",
-		    dataBlock->sampleRate, static_cast<uint32_t> (dataBlock->sampleSize),
-		    static_cast<uint32_t> (dataBlock->numChannels),
-		    static_cast<uint32_t> (dataBlock->numSamples));
+		if (auto dataBlock = toDataBlock (blocks[index]))
+		{
+			stream->timing.onBlockReceived (dataBlock, receiveTime);
+			if (dataBlock->payloadFormat == PayloadFormat::Stereo)
+			{
+				// no audio for the analyzer, the overview and the recorder
+				receiveStereoPoints (*stream, dataBlock);
+				continue;
+			}
+			if (!isAnalyzed)
+				continue;
+			analyzer.push (dataBlock, stream->blockSize);
+			recorder.push (dataBlock, stream->blockSize);
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+void DataExchangeController::onTimer (Timer*)
+{
+	auto now = getSteadyTime ();
+	isLogDue = now >= nextLogTime;
+	if (isLogDue)
+		nextLogTime = now + kLogInterval;
+
+	AnalysisResult result;
+	if (analyzer.getLatestResult (result))
+		updateViews (result);
+	for (auto index = 0u; index < kMaxStreams; ++index)
+	{
+		ExchangeTimingStatistics statistics;
+		if (streams[index].isOpen && streams[index].timing.getLatestStatistics (statistics))
+			updateTimingViews (index, statistics);
+		StereoMeterResult stereo;
+		if (streams[index].isOpen && streams[index].stereoResults.read (stereo))
+			updateStereoViews (index, stereo);
+	}
+}
+
+//------------------------------------------------------------------------
+void DataExchangeController::receiveStereoPoints (ReceivedStream& stream, const DataBlock* block)
+{
+	// a few points per block, cheap enough for the receiving thread
+	auto& result = stream.stereo;
+	auto points = getChannelData<StereoPoint> (block, 0);
+	for (auto index = 0u; index < block->numSamples; ++index)
+	{
+		result.points[result.nextPoint] = points[index];
+		result.nextPoint = (result.nextPoint + 1) % kGoniometerPoints;
+		result.numPoints = std::min (result.numPoints + 1, kGoniometerPoints);
+	}
+	if (block->numSamples == 0)
+		return;
+	result.latest = points[block->numSamples - 1];
+	result.samplePosition =
+	    block->samplePosition + static_cast<uint64> (block->numSamples) * block->decimation;
+	stream.stereoResults.write (result);
+}
+
+//------------------------------------------------------------------------
+void DataExchangeController::stopAnalysis ()
+{
+	if (displayTimer)
+	{
+		displayTimer->stop ();
+		displayTimer = nullptr;
+	}
+	analyzer.stop ();
+}
+
+//------------------------------------------------------------------------
+void DataExchangeController::startRecording (uint32 blockSize)
+{
+	// record what this instance receives if a directory is given, for offline debugging
+	auto directory = std::getenv ("DATAEXCHANGE_TUTORIAL_RECORDING_DIR");
+	if (!directory || !*directory)
+		return;
+
+	static std::atomic<uint32> recordingCounter {0};
+	auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds> (
+	    std::chrono::system_clock::now ().time_since_epoch ());
+	auto path = std::string (directory) + "/dataexchange_" +
+	            std::to_string (milliseconds.count ()) + "_" +
+	            std::to_string (recordingCounter++) +
+	            (recorderConfig.format == RecordingFormat::Wave64 ? ".w64" : ".raw");
+	if (recorder.start (path, recorderConfig, blockSize))
+		FDebugPrint ("Recording to %s\n", path.data ());
+	else
+		FDebugPrint ("Recording to %s failed\n", path.data ());
+}
+
+//------------------------------------------------------------------------
+void DataExchangeController::stopRecording ()
+{
+	if (!recorder.isRecording ())
+		return;
+	recorder.stop ();
+	auto statistics = recorder.getStatistics ();
+	FDebugPrint ("Recording stopped. Bytes: %llu, blocks recorded: %u, lost: %u, skipped: %u, "
+	             "missing samples: %llu%s\n",
+	             static_cast<unsigned long long> (statistics.bytesWritten),
+	             statistics.blocksRecorded, statistics.blocksLost, statistics.blocksSkipped,
+	             static_cast<unsigned long long> (statistics.samplesMissing),
+	             statistics.writeFailed ? ", write failed" : "");
+}
+
+//------------------------------------------------------------------------
+void DataExchangeController::updateViews (const AnalysisResult& result)
+{
+	// a plug-in with an editor would update its meter views here, the log is throttled
+	if (result.blocksDropped != loggedBlocksDropped || result.blocksLost != loggedBlocksLost)
+	{
+		loggedBlocksDropped = result.blocksDropped;
+		loggedBlocksLost = result.blocksLost;
+		FDebugPrint ("Blocks dropped: %u, samples dropped: %llu, blocks lost: %u, max queue "
+		             "depth: %u\n",
+		             result.blocksDropped, static_cast<unsigned long long> (result.samplesDropped),
+		             result.blocksLost, streams[kAnalyzedStream].maxQueueDepth.load ());
+	}
+	auto recording = recorder.getStatistics ();
+	if (recorder.isRecording () && (recording.blocksLost != loggedRecordingBlocksLost ||
+	                                recording.writeFailed != loggedRecordingWriteFailed))
+	{
+		loggedRecordingBlocksLost = recording.blocksLost;
+		loggedRecordingWriteFailed = recording.writeFailed;
+		FDebugPrint ("Recording: blocks lost: %u%s\n", recording.blocksLost,
+		             recording.writeFailed ? ", write failed" : "");
+	}
+
+	// a waveform view would draw result.overview, one range per pixel
+	if (!isLogDue)
+		return;
+
+	FDebugPrint ("Position: %llu, Peak: %.3f %.3f, RMS: %.3f %.3f\n",
+	             static_cast<unsigned long long> (result.samplePosition), result.peak[0],
+	             result.peak[1], result.rms[0], result.rms[1]);
+	FDebugPrint ("Loudness: M %.1f S %.1f I %.1f LUFS, True Peak: %.1f dBTP\n",
+	             result.momentaryLoudness, result.shortTermLoudness, result.integratedLoudness,
+	             20. * std::log10 (std::max (result.maxTruePeak, 1e-10f)));
+	if (result.hasSpectrum)
+	{
+		auto loudest = std::max_element (result.spectrum.begin (), result.spectrum.end ());
+		auto bin = static_cast<uint32> (loudest - result.spectrum.begin ());
+		FDebugPrint ("Spectrum: loudest band at %.0f Hz, %.1f dB\n",
+		             SpectrumAnalyzer::getDisplayBinFrequency (bin, result.sampleRate), *loudest);
+	}
+	if (result.hasOverview && result.sampleRate > 0)
+	{
+		FDebugPrint ("Overview: %.1f s in %llu KB\n",
+		             (result.overviewEnd - result.overviewBegin) /
+		                 static_cast<double> (result.sampleRate),
+		             static_cast<unsigned long long> (result.overviewMemorySize / 1024));
+	}
+}
+
+//------------------------------------------------------------------------
+void DataExchangeController::updateStereoViews (Vst::DataExchangeUserContextID userContextID,
+                                                const StereoMeterResult& result)
+{
+	// a goniometer would draw result.points, x and y are already rotated
+	if (!isLogDue)
+		return;
+	auto toDecibels = [] (float energy) { return 10. * std::log10 (std::max (energy, 1e-12f)); };
+	FDebugPrint ("Stream %u stereo: correlation %.2f, mid %.1f dB, side %.1f dB, %u points\n",
+	             userContextID, result.latest.correlation, toDecibels (result.latest.midEnergy),
+	             toDecibels (result.latest.sideEnergy), result.numPoints);
+}
+
+//------------------------------------------------------------------------
+void DataExchangeController::updateTimingViews (Vst::DataExchangeUserContextID userContextID,
+                                                const ExchangeTimingStatistics& statistics)
+{
+	auto& stream = streams[userContextID];
+	if (statistics.blocksMissing != stream.loggedBlocksMissing ||
+	    statistics.transportJumps != stream.loggedTransportJumps)
+	{
+		stream.loggedBlocksMissing = statistics.blocksMissing;
+		stream.loggedTransportJumps = statistics.transportJumps;
+		FDebugPrint ("Stream %u blocks missing: %u, transport jumps: %u\n", userContextID,
+		             statistics.blocksMissing, statistics.transportJumps);
 	}
+	if (!isLogDue)
+		return;
+	FDebugPrint ("Stream %u exchange latency: %.2f ms (max %.2f), end to end: %.2f ms (max "
+	             "%.2f), drift: %.1f ppm over %.0f s\n",
+	             userContextID, statistics.meanExchangeLatency, statistics.maxExchangeLatency,
+	             statistics.meanEndToEndLatency, statistics.maxEndToEndLatency, statistics.drift,
+	             statistics.driftDuration);
 }
 
 //------------------------------------------------------------------------
@@ -4,15 +4,25 @@
 
 #pragma once
 
+#include "blockanalyzer.h"
+#include "blockrecorder.h"
 #include "dataexchange.h"
+#include "exchangetiming.h"
+#include "sharedmemoryexchange.h"
+#include "triplebuffer.h"
+#include "base/source/timer.h"
 #include "public.sdk/source/vst/vsteditcontroller.h"
+#include <array>
+#include <atomic>
 
 namespace Steinberg::Tutorial {
 
 //------------------------------------------------------------------------
 //  DataExchangeController
 //------------------------------------------------------------------------
-class DataExchangeController : public Vst::EditControllerEx1, public Vst::IDataExchangeReceiver
+class DataExchangeController : public Vst::EditControllerEx1,
+                               public Vst::IDataExchangeReceiver,
+                               public ITimerCallback
 {
 public:
 //------------------------------------------------------------------------
@@ -23,6 +33,7 @@ public:
 	}
 
 	// EditController
+	tresult PLUGIN_API terminate () override;
 	tresult PLUGIN_API notify (Vst::IMessage* message) override;
 
 	// IDataExchangeReceiver
@@ -32,6 +43,9 @@ public:
 	void PLUGIN_API onDataExchangeBlocksReceived (Vst::DataExchangeUserContextID userContextID,
 	                                              uint32 numBlocks, Vst::DataExchangeBlock* blocks,
 	                                              TBool onBackgroundThread) override;
+
+	// ITimerCallback
+	void onTimer (Timer*) override;
 	//---Interface---------
 	DEFINE_INTERFACES
 		// Here you can add more supported VST3 interfaces
@@ -41,7 +55,71 @@ public:
 
 //------------------------------------------------------------------------
 private:
+	static constexpr uint32 kAnalyzerRingSize = 64;
+	static constexpr uint32 kGoniometerPoints = 256;
+	// the views update at kResultRate, the log only once per interval or when blocks go missing
+	static constexpr int64 kLogInterval = 1000000000;
+	// the processor numbers its streams from 0, the first one is analyzed, recorded and kept in
+	// the waveform overview
+	static constexpr uint32 kMaxStreams = 8;
+	static constexpr Vst::DataExchangeUserContextID kAnalyzedStream = 0;
+
+	/** The newest points of a PayloadFormat::Stereo stream, for a phase meter and a goniometer. */
+	struct StereoMeterResult
+	{
+		// position after the last point
+		uint64 samplePosition {0};
+		StereoPoint latest {};
+		// once numPoints reaches kGoniometerPoints, nextPoint is the oldest
+		std::array<StereoPoint, kGoniometerPoints> points {};
+		uint32 nextPoint {0};
+		uint32 numPoints {0};
+	};
+
+	struct ReceivedStream
+	{
+		bool isOpen {false};
+		uint32 blockSize {0};
+		ExchangeTimingTracker timing;
+		// most blocks delivered in one call, the number of blocks queued at the same time
+		std::atomic<uint32> maxQueueDepth {0};
+		// owned by the receiving thread, handed to the UI thread after every stereo block
+		StereoMeterResult stereo;
+		TripleBuffer<StereoMeterResult> stereoResults;
+		// counters of the last log, owned by the UI thread
+		uint32 loggedBlocksMissing {0};
+		uint32 loggedTransportJumps {0};
+	};
+
+	ReceivedStream* getStream (Vst::DataExchangeUserContextID userContextID)
+	{
+		return userContextID < kMaxStreams ? &streams[userContextID] : nullptr;
+	}
+	void stopAnalysis ();
+	void startRecording (uint32 blockSize);
+	void stopRecording ();
+	void receiveStereoPoints (ReceivedStream& stream, const DataBlock* block);
+	void updateViews (const AnalysisResult& result);
+	void updateStereoViews (Vst::DataExchangeUserContextID userContextID,
+	                        const StereoMeterResult& result);
+	void updateTimingViews (Vst::DataExchangeUserContextID userContextID,
+	                        const ExchangeTimingStatistics& statistics);
+
 	Vst::DataExchangeReceiverHandler dataExchange {this};
+	SharedMemoryReceiverHandler sharedMemoryExchange {this};
+	// indexed by the userContextID, never resized while the blocks arrive
+	std::array<ReceivedStream, kMaxStreams> streams;
+	BlockAnalyzer analyzer;
+	BlockRecorder recorder;
+	RecorderConfig recorderConfig;
+	IPtr<Timer> displayTimer;
+	// owned by the UI thread
+	int64 nextLogTime {0};
+	bool isLogDue {false};
+	uint32 loggedBlocksDropped {0};
+	uint32 loggedBlocksLost {0};
+	uint32 loggedRecordingBlocksLost {0};
+	bool loggedRecordingWriteFailed {false};
 };
 
 //------------------------------------------------------------------------
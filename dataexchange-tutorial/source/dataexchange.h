@@ -5,21 +5,189 @@
 #pragma once
 
 #include "public.sdk/source/vst/utility/dataexchange.h"
+#include <chrono>
 #include <cstdint>
+#include <numeric>
 
 //------------------------------------------------------------------------
 namespace Steinberg::Tutorial {
 
+//------------------------------------------------------------------------
+enum class PayloadFormat : uint16_t
+{
+	/** float32, one channel after the other */
+	Planar,
+	/** float32, the samples of all channels for one frame after the other */
+	Interleaved,
+	/** int16 (-32767..32767 for -1..1), one channel after the other */
+	Int16,
+	/** one DecimatedPoint for every 'decimation' samples, one channel after the other */
+	Decimated,
+	/** one StereoPoint for every 'decimation' frames of the first two channels, numChannels is 1 */
+	Stereo,
+};
+
+//------------------------------------------------------------------------
+/** Reduction of 'decimation' input samples of one channel. */
+struct DecimatedPoint
+{
+	float min;
+	float max;
+	float rms;
+};
+
+//------------------------------------------------------------------------
+/** Reduction of 'decimation' frames of a stereo signal for phase meters and goniometers. */
+struct StereoPoint
+{
+	// L/R correlation up to the end of the point, averaged over StreamingConfig::correlationTime:
+	// 1 for mono, 0 for unrelated channels, -1 for inverted ones, 0 for silence
+	float correlation;
+	// mean squares of mid (L + R) / 2 and side (L - R) / 2 over the point
+	float midEnergy;
+	float sideEnergy;
+	// goniometer dot of the first frame: x = (R - L) / sqrt (2), y = (L + R) / sqrt (2), so mono
+	// draws a vertical line
+	float x;
+	float y;
+};
+
+//------------------------------------------------------------------------
+/** Alignment of the blocks and of the samples. The header is padded to a multiple of it, so the
+ *	first channel starts on a cache line; the processor rounds the channel stride so the others do
+ *	as well. */
+static constexpr uint32_t kDataBlockAlignment = 64;
+
+//------------------------------------------------------------------------
+/** Which timestamps of a DataBlock come from the host. */
+enum TimestampFlags : uint32_t
+{
+	/** projectSamplePosition is ProcessContext::projectTimeSamples */
+	kProjectPositionValid = 1 << 0,
+	/** systemTime is ProcessContext::systemTime, else it equals captureTime */
+	kHostSystemTime = 1 << 1,
+	/** the transport of the host was playing, else the project position stands still */
+	kTransportPlaying = 1 << 2,
+};
+
+//------------------------------------------------------------------------
+static constexpr uint32_t kNoTriggerFrame = ~uint32_t {0};
+
 //------------------------------------------------------------------------
 struct DataBlock
 {
 	uint32_t sampleRate;
+	// size of one frame of one channel in bytes, see getFrameSize
 	uint16_t sampleSize;
 	uint16_t numChannels;
+	// number of frames in the block (points for PayloadFormat::Decimated and Stereo)
 	uint32_t numSamples;
-	float samples[0];
+	// distance between the first frame of two channels, in frames
+	uint32_t channelStride;
+	// position of the first sample in the stream, counted since the processing was activated
+	uint64_t samplePosition;
+	PayloadFormat payloadFormat;
+	// input samples per frame, 1 unless PayloadFormat::Decimated or Stereo
+	uint16_t decimation;
+	// distance between two frames of a channel, in values
+	uint32_t frameStride;
+	// counters of the processor since activation, including this block. blocksSent is also the
+	// sequence number of the block, a gap means that blocks were lost on the way
+	uint32_t blocksSent;
+	uint32_t blocksDropped;
+	uint64_t samplesDropped;
+	// timestamps of the first sample, see TimestampFlags
+	uint32_t timestampFlags;
+	// frame of the trigger point in a triggered capture, kNoTriggerFrame for streamed blocks and
+	// for captures started by the auto trigger
+	uint32_t triggerFrame;
+	// position of the first sample in the project, moves with the transport
+	int64_t projectSamplePosition;
+	// nanoseconds on the clock of the host
+	int64_t systemTime;
+	// nanoseconds of getSteadyTime when the first sample was processed and when the block was sent
+	int64_t captureTime;
+	int64_t sendTime;
+	alignas (kDataBlockAlignment) float samples[0];
 };
 
+static_assert (sizeof (DataBlock) == 2 * kDataBlockAlignment, "the header must fill cache lines");
+
+//------------------------------------------------------------------------
+/** Nanoseconds of the steady clock, which is the same for all processes of a machine on Linux,
+ *	macOS and Windows. Used for the capture and send times. */
+inline int64_t getSteadyTime ()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds> (
+	           std::chrono::steady_clock::now ().time_since_epoch ())
+	    .count ();
+}
+
+//------------------------------------------------------------------------
+/** Element of a buffer holding DataBlocks outside of the exchange queue. */
+struct alignas (kDataBlockAlignment) DataBlockStorage
+{
+	uint8_t bytes[kDataBlockAlignment];
+};
+
+//------------------------------------------------------------------------
+/** Size of one frame of one channel in bytes. */
+constexpr uint32_t getFrameSize (PayloadFormat format)
+{
+	switch (format)
+	{
+		case PayloadFormat::Int16:
+			return sizeof (int16_t);
+		case PayloadFormat::Decimated:
+			return sizeof (DecimatedPoint);
+		case PayloadFormat::Stereo:
+			return sizeof (StereoPoint);
+		default:
+			return sizeof (float);
+	}
+}
+
+//------------------------------------------------------------------------
+/** Rounds numFrames up to the next count of frames whose size is a multiple of alignment, so that
+ *	consecutive channels stay aligned. */
+constexpr uint32_t getAlignedFrameCount (uint32_t numFrames, PayloadFormat format,
+                                        uint32_t alignment)
+{
+	auto step = alignment / std::gcd (getFrameSize (format), alignment);
+	return (numFrames + step - 1) / step * step;
+}
+
+//------------------------------------------------------------------------
+/** First value of a channel. Type must match the payload format: float for Planar and Interleaved,
+ *	int16_t for Int16, DecimatedPoint for Decimated and StereoPoint for Stereo. */
+template <typename T>
+inline T* getChannelData (DataBlock* block, uint32_t channel)
+{
+	auto values = reinterpret_cast<T*> (&block->samples[0]);
+	if (block->payloadFormat == PayloadFormat::Interleaved)
+		return values + channel;
+	return values + channel * block->channelStride;
+}
+
+//------------------------------------------------------------------------
+template <typename T>
+inline const T* getChannelData (const DataBlock* block, uint32_t channel)
+{
+	return getChannelData<T> (const_cast<DataBlock*> (block), channel);
+}
+
+//------------------------------------------------------------------------
+inline float* getChannelSamples (DataBlock* block, uint32_t channel)
+{
+	return getChannelData<float> (block, channel);
+}
+
+//------------------------------------------------------------------------
+inline const float* getChannelSamples (const DataBlock* block, uint32_t channel)
+{
+	return getChannelData<float> (block, channel);
+}
+
 //------------------------------------------------------------------------
 inline DataBlock* toDataBlock (const Vst::DataExchangeBlock& block)
 {
@@ -0,0 +1,699 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "exchangestream.h"
+#include "../../common/source/busprocessing.h"
+
+#include "base/source/fdebug.h"
+#include "pluginterfaces/vst/ivstdataexchange.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Steinberg::Tutorial {
+namespace {
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+inline SampleType** getSampleBuffers (const Vst::AudioBusBuffers& buffers)
+{
+	if constexpr (std::is_same_v<SampleType, Vst::Sample64>)
+		return buffers.channelBuffers64;
+	else
+		return buffers.channelBuffers32;
+}
+
+//------------------------------------------------------------------------
+/** The samples of the channel from offset on, nullptr if the channel is silent or the bus has
+ *	fewer channels than the stream. Every channel of a block is written, a nullptr as silence. */
+template <typename SampleType>
+inline const SampleType* getInputChannel (const Vst::AudioBusBuffers& input, int32 channel,
+                                          uint32 offset)
+{
+	if (channel >= input.numChannels || isChannelSilent (input.silenceFlags, channel))
+		return nullptr;
+	return getSampleBuffers<SampleType> (input)[channel] + offset;
+}
+
+//------------------------------------------------------------------------
+inline void copyToFloat (const float* input, uint32 numSamples, float* output)
+{
+	if (input)
+		memcpy (output, input, numSamples * sizeof (float));
+	else
+		memset (output, 0, numSamples * sizeof (float));
+}
+
+//------------------------------------------------------------------------
+inline void copyToFloat (const double* input, uint32 numSamples, float* output)
+{
+	convertToFloat (input, static_cast<int32> (numSamples), output);
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+// ExchangeStream
+//------------------------------------------------------------------------
+ExchangeStream::ExchangeStream (Vst::IAudioProcessor* processor, const StreamingConfig& config,
+                                Vst::DataExchangeUserContextID userContextID)
+: config (config)
+, userContextID (userContextID)
+, dataExchange (processor, [this] (Vst::DataExchangeHandler::Config& exchangeConfig,
+                                   const Vst::ProcessSetup& /*setup*/) {
+	return configureExchange (exchangeConfig);
+})
+{
+}
+
+//------------------------------------------------------------------------
+ExchangeStream::~ExchangeStream () noexcept = default;
+
+//------------------------------------------------------------------------
+void ExchangeStream::onConnect (Vst::IConnectionPoint* other, FUnknown* hostContext)
+{
+	dataExchange.onConnect (other, hostContext);
+	sharedMemoryExchange.onConnect (other, hostContext);
+	FUnknownPtr<Vst::IDataExchangeHandler> hostHandler (hostContext);
+	hostSupportsDataExchange = static_cast<bool> (hostHandler);
+}
+
+//------------------------------------------------------------------------
+void ExchangeStream::onDisconnect (Vst::IConnectionPoint* other)
+{
+	dataExchange.onDisconnect (other);
+	sharedMemoryExchange.onDisconnect ();
+}
+
+//------------------------------------------------------------------------
+void ExchangeStream::onActivate (const Vst::ProcessSetup& setup, uint16 channelCount)
+{
+	numChannels = channelCount;
+	sampleRate = setup.sampleRate;
+	silentInput.numChannels = std::min<int32> (numChannels, 64);
+	silentInput.silenceFlags = ~uint64 {0};
+	samplePosition = 0;
+	statistics = {};
+	overflowActive = false;
+	samplesDroppedInOverflow = 0;
+	currentExchangeBlock = InvalidDataExchangeBlock;
+	if (!useSharedMemory () || !openSharedMemoryExchange ())
+		dataExchange.onActivate (setup);
+}
+
+//------------------------------------------------------------------------
+void ExchangeStream::onDeactivate ()
+{
+	if (sharedMemoryExchange.isActive ())
+		sharedMemoryExchange.onDeactivate ();
+	else
+		dataExchange.onDeactivate ();
+	currentExchangeBlock = InvalidDataExchangeBlock;
+	FDebugPrint ("ExchangeStream %u: %u blocks sent, %u blocks and %llu samples dropped\n",
+	             userContextID, statistics.blocksSent, statistics.blocksDropped,
+	             static_cast<unsigned long long> (statistics.samplesDropped));
+}
+
+//------------------------------------------------------------------------
+bool ExchangeStream::configureExchange (Vst::DataExchangeHandler::Config& exchangeConfig)
+{
+	payloadFormat = config.payloadFormat;
+	auto isReduced =
+	    payloadFormat == PayloadFormat::Decimated || payloadFormat == PayloadFormat::Stereo;
+	decimation = isReduced ? std::max<uint16> (config.decimation, 1) : 1;
+	decimationPosition = 0;
+	accumulators.assign (numChannels, {});
+	stereoAccumulator.reset ();
+	stereoCorrelation.setup (sampleRate, config.correlationTime);
+	channelPointers.resize (numChannels);
+	channelPointers64.resize (numChannels);
+
+	// the channel stride is the capacity, round it up to keep the channels aligned
+	auto alignment = config.channelAlignment;
+	if (alignment == 0 || alignment > kDataBlockAlignment || (alignment & (alignment - 1)))
+		alignment = kDataBlockAlignment;
+	framesPerBlock = std::max<uint32> (config.framesPerBlock, 1);
+	if (payloadFormat != PayloadFormat::Interleaved)
+		framesPerBlock = getAlignedFrameCount (framesPerBlock, payloadFormat, alignment);
+
+	auto payloadChannels = payloadFormat == PayloadFormat::Stereo ? 1u : numChannels;
+	auto payloadSize = framesPerBlock * payloadChannels * getFrameSize (payloadFormat);
+	blockSize = payloadSize + sizeof (DataBlock);
+	exchangeConfig.blockSize = blockSize;
+	exchangeConfig.numBlocks = std::max<uint32> (config.numBlocks, 2);
+	exchangeConfig.alignment = kDataBlockAlignment;
+
+	// the coalesced block has the size of an exchange block and halves an even count
+	coalesceDecimation = std::max<uint16> (config.decimation, 1);
+	auto pointSize = std::max<uint32> (numChannels, 1) * sizeof (DecimatedPoint);
+	coalesceCapacity = payloadSize / pointSize;
+	// align its channels as well unless the block is too small for it
+	auto step = getAlignedFrameCount (1, PayloadFormat::Decimated, alignment);
+	if (coalesceCapacity >= 2 * step)
+		coalesceCapacity = coalesceCapacity / step * step;
+	coalesceCapacity &= ~1u;
+	// the stereo points are already smaller than decimated ones of both channels
+	overflowPolicy = config.overflowPolicy;
+	if (payloadFormat == PayloadFormat::Stereo && overflowPolicy == OverflowPolicy::Coalesce)
+		overflowPolicy = OverflowPolicy::DropOldest;
+	if (overflowPolicy == OverflowPolicy::DropNewest)
+		overflowBuffer.clear ();
+	else
+		overflowBuffer.resize ((blockSize + kDataBlockAlignment - 1) / kDataBlockAlignment);
+
+	triggered = config.trigger.mode != TriggerMode::Off && !isReduced;
+	historyCapacity = 0;
+	// the pre-trigger frames leave at least the trigger point in the block
+	if (triggered)
+		historyCapacity = std::min (config.trigger.preTriggerFrames, framesPerBlock - 1);
+	history.assign (static_cast<size_t> (historyCapacity) * numChannels, 0.f);
+	historyPointers.resize (numChannels);
+	historyPosition = 0;
+	historyFill = 0;
+	edgeReady = false;
+	nextArmPosition = 0;
+	exchangeConfig.userContextID = userContextID;
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool ExchangeStream::useSharedMemory () const
+{
+	if (!SharedMemoryExchangeHandler::isSupported ())
+		return false;
+	switch (config.transport)
+	{
+		case ExchangeTransport::Automatic: return !hostSupportsDataExchange;
+		case ExchangeTransport::Host: return false;
+		case ExchangeTransport::SharedMemory: return true;
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------
+bool ExchangeStream::openSharedMemoryExchange ()
+{
+	Vst::DataExchangeHandler::Config exchangeConfig {};
+	if (!configureExchange (exchangeConfig))
+		return false;
+	if (sharedMemoryExchange.onActivate (exchangeConfig))
+		return true;
+	FDebugPrint ("ExchangeStream %u: shared memory exchange failed, using the host\n",
+	             userContextID);
+	return false;
+}
+
+//------------------------------------------------------------------------
+void ExchangeStream::initBlock (DataBlock* block, PayloadFormat format, uint16 blockDecimation,
+                                uint32 capacity)
+{
+	block->sampleRate = static_cast<uint32_t> (sampleRate);
+	block->numChannels = format == PayloadFormat::Stereo ? 1 : numChannels;
+	block->sampleSize = static_cast<uint16_t> (getFrameSize (format));
+	block->numSamples = 0;
+	block->samplePosition = samplePosition;
+	block->payloadFormat = format;
+	block->decimation = blockDecimation;
+	block->triggerFrame = kNoTriggerFrame;
+	if (format == PayloadFormat::Interleaved)
+	{
+		block->channelStride = 1;
+		block->frameStride = numChannels;
+	}
+	else
+	{
+		block->channelStride = capacity;
+		block->frameStride = 1;
+	}
+	stampBlock (block);
+}
+
+//------------------------------------------------------------------------
+void ExchangeStream::stampBlock (DataBlock* block)
+{
+	// the first sample of the block lies this far into the process call
+	auto offset = static_cast<int64> (samplePosition - processPosition);
+	int64 nanoseconds = 0;
+	if (sampleRate > 0.)
+		nanoseconds = static_cast<int64> (offset * 1e9 / sampleRate);
+	block->timestampFlags = processTiming.flags;
+	block->projectSamplePosition = processTiming.projectPosition;
+	if (processTiming.flags & kTransportPlaying)
+		block->projectSamplePosition += offset;
+	block->systemTime = processTiming.systemTime + nanoseconds;
+	block->captureTime = processTiming.captureTime + nanoseconds;
+	block->sendTime = 0;
+}
+
+//------------------------------------------------------------------------
+Vst::DataExchangeBlock ExchangeStream::getCurrentOrNewBlock ()
+{
+	if (sharedMemoryExchange.isActive ())
+		return sharedMemoryExchange.getCurrentOrNewBlock ();
+	return dataExchange.getCurrentOrNewBlock ();
+}
+
+//------------------------------------------------------------------------
+void ExchangeStream::acquireNewExchangeBlock ()
+{
+	currentExchangeBlock = getCurrentOrNewBlock ();
+	auto block = toDataBlock (currentExchangeBlock);
+	if (block == nullptr)
+		return;
+	if (overflowActive)
+		endOverflow (block);
+	else
+		initBlock (block, payloadFormat, decimation, framesPerBlock);
+}
+
+//------------------------------------------------------------------------
+void ExchangeStream::sendCurrentBlock ()
+{
+	auto block = toDataBlock (currentExchangeBlock);
+	++statistics.blocksSent;
+	block->blocksSent = statistics.blocksSent;
+	block->blocksDropped = statistics.blocksDropped;
+	block->samplesDropped = statistics.samplesDropped;
+	block->sendTime = getSteadyTime ();
+	if (sharedMemoryExchange.isActive ())
+		sharedMemoryExchange.sendCurrentBlock ();
+	else
+		dataExchange.sendCurrentBlock ();
+	currentExchangeBlock = InvalidDataExchangeBlock;
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void ExchangeStream::writeOverflow (const Vst::AudioBusBuffers& input, uint32 offset,
+                                    uint32 numSamples)
+{
+	auto block = getOverflowBlock ();
+	if (!overflowActive)
+	{
+		overflowActive = true;
+		samplesDroppedInOverflow = 0;
+		if (overflowPolicy == OverflowPolicy::DropOldest)
+			initBlock (block, payloadFormat, decimation, framesPerBlock);
+		else if (overflowPolicy == OverflowPolicy::Coalesce)
+			initBlock (block, PayloadFormat::Decimated, coalesceDecimation, coalesceCapacity);
+	}
+
+	while (numSamples > 0)
+	{
+		uint32 numSamplesWritten = 0;
+		if (overflowPolicy == OverflowPolicy::DropOldest)
+		{
+			if (block->numSamples == framesPerBlock)
+			{
+				// still no free block, replace the kept one
+				++statistics.blocksDropped;
+				statistics.samplesDropped += uint64 {framesPerBlock} * block->decimation;
+				initBlock (block, payloadFormat, decimation, framesPerBlock);
+			}
+			numSamplesWritten = writeToBlock<SampleType> (block, input, offset, numSamples);
+		}
+		else if (overflowPolicy == OverflowPolicy::Coalesce && coalesceCapacity >= 2)
+		{
+			if (block->numSamples == coalesceCapacity && block->decimation <= 0x7FFF)
+			{
+				for (auto channel = 0u; channel < numChannels; ++channel)
+				{
+					auto points = getChannelData<DecimatedPoint> (block, channel);
+					for (auto index = 0u; index < coalesceCapacity / 2; ++index)
+					{
+						points[index] =
+						    mergeDecimatedPoints (points[index * 2], points[index * 2 + 1]);
+					}
+				}
+				block->numSamples /= 2;
+				block->decimation *= 2;
+			}
+			numSamplesWritten = writeDecimated<SampleType> (block, input, offset, numSamples);
+		}
+		if (numSamplesWritten == 0)
+		{
+			// DropNewest, or the coalesced block cannot be reduced any further
+			samplesDroppedInOverflow += numSamples;
+			statistics.samplesDropped += numSamples;
+			samplePosition += numSamples;
+			return;
+		}
+		offset += numSamplesWritten;
+		numSamples -= numSamplesWritten;
+		samplePosition += numSamplesWritten;
+	}
+}
+
+//------------------------------------------------------------------------
+void ExchangeStream::endOverflow (DataBlock* block)
+{
+	overflowActive = false;
+	auto samplesPerBlock = uint64 {framesPerBlock} * decimation;
+	statistics.blocksDropped += static_cast<uint32> (
+	    (samplesDroppedInOverflow + samplesPerBlock - 1) / samplesPerBlock);
+
+	switch (overflowPolicy)
+	{
+		case OverflowPolicy::DropNewest:
+		{
+			initBlock (block, payloadFormat, decimation, framesPerBlock);
+			break;
+		}
+		case OverflowPolicy::DropOldest:
+		{
+			// continue with the kept block, a partial decimated point stays in the accumulators
+			memcpy (block, getOverflowBlock (), blockSize);
+			if (block->numSamples == framesPerBlock)
+			{
+				sendCurrentBlock ();
+				acquireNewExchangeBlock ();
+			}
+			break;
+		}
+		case OverflowPolicy::Coalesce:
+		{
+			flushDecimatedPoint (getOverflowBlock ());
+			memcpy (block, getOverflowBlock (), blockSize);
+			sendCurrentBlock ();
+			acquireNewExchangeBlock ();
+			break;
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+void ExchangeStream::flushDecimatedPoint (DataBlock* block)
+{
+	if (decimationPosition == 0 || block->numSamples == block->channelStride)
+	{
+		// a point which does not fit is lost
+		for (auto& accumulator : accumulators)
+			accumulator.reset ();
+		decimationPosition = 0;
+		return;
+	}
+	// the last point covers less than 'decimation' samples
+	for (auto channel = 0u; channel < numChannels; ++channel)
+	{
+		getChannelData<DecimatedPoint> (block, channel)[block->numSamples] =
+		    accumulators[channel].getPoint ();
+		accumulators[channel].reset ();
+	}
+	++block->numSamples;
+	decimationPosition = 0;
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+uint32 ExchangeStream::writeToBlock (DataBlock* block, const Vst::AudioBusBuffers& input,
+                                     uint32 offset, uint32 numSamples)
+{
+	if (block->payloadFormat == PayloadFormat::Decimated)
+		return writeDecimated<SampleType> (block, input, offset, numSamples);
+	if (block->payloadFormat == PayloadFormat::Stereo)
+		return writeStereo<SampleType> (block, input, offset, numSamples);
+
+	auto numFrames = std::min<uint32> (framesPerBlock - block->numSamples, numSamples);
+	auto& inputPointers = getChannelPointers<SampleType> ();
+	for (auto channel = 0; channel < numChannels; ++channel)
+		inputPointers[channel] = getInputChannel<SampleType> (input, channel, offset);
+
+	switch (block->payloadFormat)
+	{
+		case PayloadFormat::Interleaved:
+		{
+			auto frames = getChannelSamples (block, 0) + block->numSamples * block->frameStride;
+			interleaveChannels (inputPointers.data (), numChannels, numFrames, frames);
+			break;
+		}
+		case PayloadFormat::Int16:
+		{
+			for (auto channel = 0; channel < numChannels; ++channel)
+			{
+				auto blockChannelData = getChannelData<int16_t> (block, channel);
+				convertToInt16 (inputPointers[channel], numFrames,
+				                blockChannelData + block->numSamples);
+			}
+			break;
+		}
+		default:
+		{
+			for (auto channel = 0; channel < numChannels; ++channel)
+			{
+				auto blockChannelData = getChannelSamples (block, channel) + block->numSamples;
+				if constexpr (std::is_same_v<SampleType, Vst::Sample64>)
+					convertToFloat (inputPointers[channel], numFrames, blockChannelData);
+				else if (inputPointers[channel])
+					memcpy (blockChannelData, inputPointers[channel], numFrames * sizeof (float));
+				else
+					memset (blockChannelData, 0, numFrames * sizeof (float));
+			}
+			break;
+		}
+	}
+	block->numSamples += numFrames;
+	return numFrames;
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+uint32 ExchangeStream::writeDecimated (DataBlock* block, const Vst::AudioBusBuffers& input,
+                                       uint32 offset, uint32 numSamples)
+{
+	// decimated blocks are planar, the channel stride is the capacity
+	uint32 numSamplesDone = 0;
+	while (numSamplesDone < numSamples && block->numSamples < block->channelStride)
+	{
+		auto count = std::min<uint32> (block->decimation - decimationPosition,
+		                               numSamples - numSamplesDone);
+		for (auto channel = 0; channel < numChannels; ++channel)
+		{
+			auto inputChannel =
+			    getInputChannel<SampleType> (input, channel, offset + numSamplesDone);
+			accumulate (inputChannel, count, accumulators[channel]);
+		}
+		decimationPosition += count;
+		numSamplesDone += count;
+		if (decimationPosition < block->decimation)
+			break;
+
+		for (auto channel = 0; channel < numChannels; ++channel)
+		{
+			getChannelData<DecimatedPoint> (block, channel)[block->numSamples] =
+			    accumulators[channel].getPoint ();
+			accumulators[channel].reset ();
+		}
+		++block->numSamples;
+		decimationPosition = 0;
+	}
+	return numSamplesDone;
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+uint32 ExchangeStream::writeStereo (DataBlock* block, const Vst::AudioBusBuffers& input,
+                                    uint32 offset, uint32 numSamples)
+{
+	// the first two channels, a mono source correlates with itself
+	auto left = getInputChannel<SampleType> (input, 0, offset);
+	auto right = input.numChannels > 1 ? getInputChannel<SampleType> (input, 1, offset) : left;
+
+	auto points = getChannelData<StereoPoint> (block, 0);
+	uint32 numSamplesDone = 0;
+	while (numSamplesDone < numSamples && block->numSamples < block->channelStride)
+	{
+		auto count = std::min<uint32> (block->decimation - decimationPosition,
+		                               numSamples - numSamplesDone);
+		accumulateStereo (left ? left + numSamplesDone : nullptr,
+		                  right ? right + numSamplesDone : nullptr, count, stereoAccumulator);
+		decimationPosition += count;
+		numSamplesDone += count;
+		if (decimationPosition < block->decimation)
+			break;
+
+		points[block->numSamples] = stereoCorrelation.addPoint (stereoAccumulator);
+		stereoAccumulator.reset ();
+		++block->numSamples;
+		decimationPosition = 0;
+	}
+	return numSamplesDone;
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void ExchangeStream::processTriggered (const Vst::AudioBusBuffers& input, uint32 numSamples)
+{
+	// continue the capture of the previous call, the next trigger cannot come before it is full
+	if (auto block = toDataBlock (currentExchangeBlock))
+	{
+		writeToBlock<SampleType> (block, input, 0, numSamples);
+		if (block->numSamples == framesPerBlock)
+			sendCurrentBlock ();
+	}
+
+	const SampleType* triggerChannel = nullptr;
+	auto channel = config.trigger.channel;
+	if (channel < input.numChannels && !isChannelSilent (input.silenceFlags, channel))
+		triggerChannel = getSampleBuffers<SampleType> (input)[channel];
+	for (auto index = 0u; index < numSamples; ++index)
+	{
+		auto value = triggerChannel ? static_cast<float> (triggerChannel[index]) : 0.f;
+		auto onEdge = detectEdge (value);
+		auto position = processPosition + index;
+		if (position < nextArmPosition)
+			continue;
+		auto autoTrigger = config.trigger.autoTrigger;
+		if (onEdge || (autoTrigger > 0 && position - nextArmPosition >= autoTrigger))
+			startCapture<SampleType> (input, index, numSamples, onEdge);
+	}
+
+	updateHistory<SampleType> (input, numSamples);
+	samplePosition = processPosition + numSamples;
+}
+
+//------------------------------------------------------------------------
+bool ExchangeStream::detectEdge (float value)
+{
+	// an edge counts once the signal was beyond the hysteresis on the other side of the level
+	const auto& trigger = config.trigger;
+	if (trigger.mode == TriggerMode::FallingEdge)
+		value = -value;
+	auto level = trigger.mode == TriggerMode::FallingEdge ? -trigger.level : trigger.level;
+	if (value <= level - trigger.hysteresis)
+		edgeReady = true;
+	else if (edgeReady && value >= level)
+	{
+		edgeReady = false;
+		return true;
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void ExchangeStream::startCapture (const Vst::AudioBusBuffers& input, uint32 index,
+                                   uint32 numSamples, bool onEdge)
+{
+	auto preFrames = std::min (historyCapacity, historyFill + index);
+	auto triggerPosition = processPosition + index;
+	nextArmPosition =
+	    triggerPosition + std::max (config.trigger.holdOff, framesPerBlock - preFrames);
+
+	currentExchangeBlock = getCurrentOrNewBlock ();
+	auto block = toDataBlock (currentExchangeBlock);
+	if (block == nullptr)
+	{
+		// the controller does not keep up, the capture is lost
+		++statistics.blocksDropped;
+		return;
+	}
+	samplePosition = triggerPosition - preFrames;
+	initBlock (block, payloadFormat, 1, framesPerBlock);
+	block->triggerFrame = onEdge ? preFrames : kNoTriggerFrame;
+
+	// the frames before the trigger point come from the history and from this call
+	auto inputFrames = std::min (preFrames, index);
+	writeHistory (block, preFrames - inputFrames);
+	auto offset = index - inputFrames;
+	writeToBlock<SampleType> (block, input, offset, numSamples - offset);
+	if (block->numSamples == framesPerBlock)
+		sendCurrentBlock ();
+}
+
+//------------------------------------------------------------------------
+void ExchangeStream::writeHistory (DataBlock* block, uint32 numFrames)
+{
+	Vst::AudioBusBuffers historyBus {};
+	historyBus.numChannels = numChannels;
+	historyBus.channelBuffers32 = historyPointers.data ();
+	// the last numFrames frames of the ring, in at most two parts
+	auto start = (historyPosition + historyCapacity - numFrames) % std::max (historyCapacity, 1u);
+	while (numFrames > 0)
+	{
+		auto count = std::min (numFrames, historyCapacity - start);
+		for (auto channel = 0u; channel < numChannels; ++channel)
+			historyPointers[channel] = history.data () + channel * historyCapacity + start;
+		writeToBlock<Vst::Sample32> (block, historyBus, 0, count);
+		numFrames -= count;
+		start = 0;
+	}
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void ExchangeStream::updateHistory (const Vst::AudioBusBuffers& input, uint32 numSamples)
+{
+	auto count = std::min (numSamples, historyCapacity);
+	auto offset = numSamples - count;
+	while (count > 0)
+	{
+		auto length = std::min (count, historyCapacity - historyPosition);
+		for (auto channel = 0; channel < numChannels; ++channel)
+		{
+			copyToFloat (getInputChannel<SampleType> (input, channel, offset), length,
+			             history.data () + channel * historyCapacity + historyPosition);
+		}
+		historyPosition = (historyPosition + length) % historyCapacity;
+		historyFill = std::min (historyFill + length, historyCapacity);
+		offset += length;
+		count -= length;
+	}
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void ExchangeStream::process (const Vst::AudioBusBuffers* input, uint32 numSamples,
+                              const ProcessTiming& timing)
+{
+	processTiming = timing;
+	processPosition = samplePosition;
+	const auto& source = input ? *input : silentInput;
+	if (triggered)
+	{
+		processTriggered<SampleType> (source, numSamples);
+		return;
+	}
+
+	if (currentExchangeBlock.blockID == Vst::InvalidDataExchangeBlockID)
+		acquireNewExchangeBlock ();
+	else if (auto block = toDataBlock (currentExchangeBlock);
+	         block->numSamples == 0 && decimationPosition == 0)
+	{
+		// acquired at the end of the previous call, its first sample belongs to this one
+		stampBlock (block);
+	}
+
+	uint32 offset = 0;
+	while (offset < numSamples)
+	{
+		auto block = toDataBlock (currentExchangeBlock);
+		if (block == nullptr)
+		{
+			// all blocks are queued, the controller does not keep up
+			writeOverflow<SampleType> (source, offset, numSamples - offset);
+			break;
+		}
+		auto numSamplesWritten =
+		    writeToBlock<SampleType> (block, source, offset, numSamples - offset);
+		offset += numSamplesWritten;
+		samplePosition += numSamplesWritten;
+		// send the block as soon as it is full
+		if (block->numSamples == framesPerBlock)
+		{
+			sendCurrentBlock ();
+			acquireNewExchangeBlock ();
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+template void ExchangeStream::process<Vst::Sample32> (const Vst::AudioBusBuffers* input,
+                                                      uint32 numSamples,
+                                                      const ProcessTiming& timing);
+template void ExchangeStream::process<Vst::Sample64> (const Vst::AudioBusBuffers* input,
+                                                      uint32 numSamples,
+                                                      const ProcessTiming& timing);
+
+//------------------------------------------------------------------------
+} // namespace Steinberg::Tutorial
@@ -0,0 +1,254 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "dataexchange.h"
+#include "payloadkernels.h"
+#include "sharedmemoryexchange.h"
+#include "public.sdk/source/vst/utility/dataexchange.h"
+#include "pluginterfaces/vst/ivstaudioprocessor.h"
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+static constexpr Vst::DataExchangeBlock InvalidDataExchangeBlock = {
+    nullptr, 0, Vst::InvalidDataExchangeBlockID};
+
+//------------------------------------------------------------------------
+/** What happens with the audio while all exchange blocks are queued because the controller does
+ *	not keep up. */
+enum class OverflowPolicy : uint16
+{
+	/** the incoming samples are lost until a block is free again */
+	DropNewest,
+	/** the last block is kept in the processor and sent when a block is free again */
+	DropOldest,
+	/** the incoming samples are reduced into one PayloadFormat::Decimated block, which halves its
+	 *	resolution whenever it is full, and sent when a block is free again. DropOldest for
+	 *	PayloadFormat::Stereo */
+	Coalesce,
+};
+
+//------------------------------------------------------------------------
+/** How the exchange blocks reach the controller. */
+enum class ExchangeTransport : uint16
+{
+	/** the shared memory ring if the host does not implement IDataExchangeHandler, else the host */
+	Automatic,
+	/** Vst::DataExchangeHandler, which falls back to IMessage if the host has no exchange queue */
+	Host,
+	/** the shared memory ring where it is supported, else the host */
+	SharedMemory,
+};
+
+//------------------------------------------------------------------------
+/** Which audio of the processor a stream publishes. */
+enum class StreamSource : uint16
+{
+	/** the main input bus, before the processing */
+	Input,
+	/** the main output bus, after the processing */
+	Output,
+	/** the sidechain input bus, silence while the host leaves it inactive */
+	Sidechain,
+};
+
+//------------------------------------------------------------------------
+/** Which edge of the trigger channel starts a capture. */
+enum class TriggerMode : uint16
+{
+	/** no trigger, the stream sends every sample */
+	Off,
+	RisingEdge,
+	FallingEdge,
+};
+
+//------------------------------------------------------------------------
+/** Oscilloscope trigger of a stream. Instead of streaming every sample, the processor sends one
+ *	block of framesPerBlock frames per trigger, starting preTriggerFrames before the trigger point.
+ *	Not available for PayloadFormat::Decimated and Stereo. */
+struct TriggerConfig
+{
+	TriggerMode mode {TriggerMode::Off};
+	uint16 channel {0};
+	float level {0.f};
+	// the signal has to be this far on the other side of the level before an edge counts again,
+	// so noise around the level does not trigger
+	float hysteresis {0.01f};
+	// frames before the trigger point, at most framesPerBlock - 1
+	uint32 preTriggerFrames {256};
+	// samples from a trigger until the next one is accepted, at least the rest of the capture
+	uint32 holdOff {4800};
+	// samples after the hold-off without a trigger until a capture starts anyway, 0 waits forever
+	uint32 autoTrigger {48000};
+};
+
+//------------------------------------------------------------------------
+/** Counters of the processor, every sent DataBlock carries their current values. */
+struct ExchangeStatistics
+{
+	uint32 blocksSent {0};
+	uint32 blocksDropped {0};
+	uint64 samplesDropped {0};
+};
+
+//------------------------------------------------------------------------
+/** Size and format of the exchange blocks. A block is sent as soon as it holds framesPerBlock
+ *	frames, so small blocks keep the latency of the controller views low. With
+ *	PayloadFormat::Decimated a frame is one DecimatedPoint of 'decimation' input samples, with
+ *	PayloadFormat::Stereo one StereoPoint of 'decimation' input frames.
+ *
+ *	Except for PayloadFormat::Interleaved framesPerBlock is rounded up so that every channel
+ *	starts at a multiple of channelAlignment bytes: 16 for SSE, 32 for AVX or 64 (default) for a
+ *	cache line. */
+struct StreamingConfig
+{
+	uint32 framesPerBlock {1024};
+	uint32 numBlocks {8};
+	PayloadFormat payloadFormat {PayloadFormat::Planar};
+	uint16 decimation {64};
+	OverflowPolicy overflowPolicy {OverflowPolicy::DropNewest};
+	uint32 channelAlignment {kDataBlockAlignment};
+	ExchangeTransport transport {ExchangeTransport::Automatic};
+	StreamSource source {StreamSource::Input};
+	TriggerConfig trigger;
+	// seconds over which PayloadFormat::Stereo averages the correlation
+	float correlationTime {0.3f};
+};
+
+//------------------------------------------------------------------------
+/** Timestamps of the first sample of a process call, the same for all streams. */
+struct ProcessTiming
+{
+	uint32 flags {0};
+	int64 projectPosition {0};
+	int64 systemTime {0};
+	int64 captureTime {0};
+};
+
+//------------------------------------------------------------------------
+/** One exchange queue of the processor with its own block size, queue depth and overflow state.
+ *	The controller tells the queues apart by their userContextID. */
+class ExchangeStream
+{
+public:
+	ExchangeStream (Vst::IAudioProcessor* processor, const StreamingConfig& config,
+	                Vst::DataExchangeUserContextID userContextID);
+	~ExchangeStream () noexcept;
+
+	const StreamingConfig& getConfig () const { return config; }
+	const ExchangeStatistics& getStatistics () const { return statistics; }
+	Vst::DataExchangeUserContextID getUserContextID () const { return userContextID; }
+
+	void onConnect (Vst::IConnectionPoint* other, FUnknown* hostContext);
+	void onDisconnect (Vst::IConnectionPoint* other);
+	/** Opens the queue for numChannels channels of the source bus. */
+	void onActivate (const Vst::ProcessSetup& setup, uint16 numChannels);
+	void onDeactivate ();
+
+	/** Audio thread: writes the samples of a process call, a nullptr input is written as
+	 *	silence. */
+	template <typename SampleType>
+	void process (const Vst::AudioBusBuffers* input, uint32 numSamples,
+	              const ProcessTiming& timing);
+
+//------------------------------------------------------------------------
+private:
+	bool configureExchange (Vst::DataExchangeHandler::Config& config);
+	bool useSharedMemory () const;
+	bool openSharedMemoryExchange ();
+	void acquireNewExchangeBlock ();
+	void initBlock (DataBlock* block, PayloadFormat format, uint16 blockDecimation,
+	                uint32 capacity);
+	void stampBlock (DataBlock* block);
+	void sendCurrentBlock ();
+	Vst::DataExchangeBlock getCurrentOrNewBlock ();
+	template <typename SampleType>
+	void processTriggered (const Vst::AudioBusBuffers& input, uint32 numSamples);
+	bool detectEdge (float value);
+	template <typename SampleType>
+	void startCapture (const Vst::AudioBusBuffers& input, uint32 index, uint32 numSamples,
+	                   bool onEdge);
+	void writeHistory (DataBlock* block, uint32 numFrames);
+	template <typename SampleType>
+	void updateHistory (const Vst::AudioBusBuffers& input, uint32 numSamples);
+	template <typename SampleType>
+	void writeOverflow (const Vst::AudioBusBuffers& input, uint32 offset, uint32 numSamples);
+	void endOverflow (DataBlock* block);
+	void flushDecimatedPoint (DataBlock* block);
+	DataBlock* getOverflowBlock () { return reinterpret_cast<DataBlock*> (overflowBuffer.data ()); }
+	template <typename SampleType>
+	uint32 writeToBlock (DataBlock* block, const Vst::AudioBusBuffers& input, uint32 offset,
+	                     uint32 numSamples);
+	template <typename SampleType>
+	uint32 writeDecimated (DataBlock* block, const Vst::AudioBusBuffers& input, uint32 offset,
+	                       uint32 numSamples);
+	template <typename SampleType>
+	uint32 writeStereo (DataBlock* block, const Vst::AudioBusBuffers& input, uint32 offset,
+	                    uint32 numSamples);
+	template <typename SampleType>
+	std::vector<const SampleType*>& getChannelPointers ()
+	{
+		if constexpr (std::is_same_v<SampleType, Vst::Sample64>)
+			return channelPointers64;
+		else
+			return channelPointers;
+	}
+
+	StreamingConfig config;
+	Vst::DataExchangeUserContextID userContextID;
+	Vst::DataExchangeHandler dataExchange;
+	SharedMemoryExchangeHandler sharedMemoryExchange;
+	bool hostSupportsDataExchange {false};
+	Vst::DataExchangeBlock currentExchangeBlock {InvalidDataExchangeBlock};
+	uint32 framesPerBlock {0};
+	PayloadFormat payloadFormat {PayloadFormat::Planar};
+	uint16 decimation {1};
+	double sampleRate {0.};
+	uint64 samplePosition {0};
+	uint16_t numChannels {0};
+	// stands in for a missing or inactive source bus
+	Vst::AudioBusBuffers silentInput {};
+
+	// timestamps of the first sample of the current process call
+	uint64 processPosition {0};
+	ProcessTiming processTiming;
+
+	// input samples of the current decimated point, the same for all channels
+	uint32 decimationPosition {0};
+	std::vector<DecimationAccumulator> accumulators;
+	std::vector<const float*> channelPointers;
+	std::vector<const double*> channelPointers64;
+	// the stereo point in progress, it shares decimationPosition
+	StereoAccumulator stereoAccumulator;
+	StereoCorrelation stereoCorrelation;
+
+	// oscilloscope trigger, the capture in progress is the current exchange block
+	bool triggered {false};
+	bool edgeReady {false};
+	uint64 nextArmPosition {0};
+	// the last input frames of every channel, for the frames before the trigger point
+	std::vector<float> history;
+	std::vector<float*> historyPointers;
+	uint32 historyCapacity {0};
+	uint32 historyPosition {0};
+	uint32 historyFill {0};
+
+	// audio arriving while no exchange block is free
+	ExchangeStatistics statistics;
+	OverflowPolicy overflowPolicy {OverflowPolicy::DropNewest};
+	bool overflowActive {false};
+	uint64 samplesDroppedInOverflow {0};
+	uint32 blockSize {0};
+	uint32 coalesceCapacity {0};
+	uint16 coalesceDecimation {1};
+	std::vector<DataBlockStorage> overflowBuffer;
+};
+
+//------------------------------------------------------------------------
+} // namespace Steinberg::Tutorial
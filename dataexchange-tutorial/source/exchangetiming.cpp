@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "exchangetiming.h"
+#include <algorithm>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+constexpr double kNanosecondsPerMillisecond = 1e6;
+constexpr double kNanosecondsPerSecond = 1e9;
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+void ExchangeTimingTracker::reset (uint32 resultRate)
+{
+	current = {};
+	publishInterval = static_cast<int64> (kNanosecondsPerSecond / std::max<uint32> (resultRate, 1));
+	lastPublishTime = 0;
+	intervalBlocks = 0;
+	exchangeLatencySum = 0.;
+	endToEndLatencySum = 0.;
+	hasPreviousBlock = false;
+	hasDriftStart = false;
+}
+
+//------------------------------------------------------------------------
+void ExchangeTimingTracker::onBlockReceived (const DataBlock* block, int64 receiveTime)
+{
+	++current.blocksReceived;
+	if (hasPreviousBlock)
+	{
+		if (block->blocksSent <= previousSequence)
+		{
+			// the processor was activated again, a new stream starts
+			hasDriftStart = false;
+		}
+		else
+		{
+			current.blocksMissing += block->blocksSent - previousSequence - 1;
+			// a stopped transport stands still and starting it is no jump
+			constexpr uint32 kPlayingFlags = kProjectPositionValid | kTransportPlaying;
+			auto samplesAdvanced = static_cast<int64> (block->samplePosition - previousPosition);
+			if ((block->timestampFlags & kPlayingFlags) == kPlayingFlags &&
+			    (previousTimestampFlags & kPlayingFlags) == kPlayingFlags &&
+			    block->projectSamplePosition - previousProjectPosition != samplesAdvanced)
+				++current.transportJumps;
+		}
+	}
+	hasPreviousBlock = true;
+	previousSequence = block->blocksSent;
+	previousPosition = block->samplePosition;
+	previousProjectPosition = block->projectSamplePosition;
+	previousTimestampFlags = block->timestampFlags;
+
+	current.samplePosition = block->samplePosition;
+	current.hasProjectPosition = (block->timestampFlags & kProjectPositionValid) != 0;
+	current.projectSamplePosition = block->projectSamplePosition;
+
+	auto exchangeLatency = (receiveTime - block->sendTime) / kNanosecondsPerMillisecond;
+	auto endToEndLatency = (receiveTime - block->captureTime) / kNanosecondsPerMillisecond;
+	exchangeLatencySum += exchangeLatency;
+	endToEndLatencySum += endToEndLatency;
+	current.maxExchangeLatency = std::max (current.maxExchangeLatency, exchangeLatency);
+	current.maxEndToEndLatency = std::max (current.maxEndToEndLatency, endToEndLatency);
+	++intervalBlocks;
+
+	updateDrift (block);
+	if (receiveTime - lastPublishTime >= publishInterval)
+		publish (receiveTime);
+}
+
+//------------------------------------------------------------------------
+void ExchangeTimingTracker::updateDrift (const DataBlock* block)
+{
+	if (!hasDriftStart || block->sampleRate != driftSampleRate ||
+	    block->samplePosition < driftStartPosition)
+	{
+		hasDriftStart = true;
+		driftSampleRate = block->sampleRate;
+		driftStartPosition = block->samplePosition;
+		driftStartTime = block->captureTime;
+		current.drift = 0.;
+		current.driftDuration = 0.;
+		return;
+	}
+	// the capture times jitter with the process calls, the longer the stream the more exact
+	auto duration = (block->captureTime - driftStartTime) / kNanosecondsPerSecond;
+	if (duration <= 0. || driftSampleRate == 0)
+		return;
+	auto measuredRate = (block->samplePosition - driftStartPosition) / duration;
+	current.drift = (measuredRate / driftSampleRate - 1.) * 1e6;
+	current.driftDuration = duration;
+}
+
+//------------------------------------------------------------------------
+void ExchangeTimingTracker::publish (int64 receiveTime)
+{
+	current.meanExchangeLatency = exchangeLatencySum / intervalBlocks;
+	current.meanEndToEndLatency = endToEndLatencySum / intervalBlocks;
+	results.write (current);
+
+	lastPublishTime = receiveTime;
+	intervalBlocks = 0;
+	exchangeLatencySum = 0.;
+	endToEndLatencySum = 0.;
+	current.maxExchangeLatency = 0.;
+	current.maxEndToEndLatency = 0.;
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
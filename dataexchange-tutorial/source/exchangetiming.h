@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "dataexchange.h"
+#include "triplebuffer.h"
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+/** Timing of the received blocks. The latencies cover the blocks received since the previous
+ *	statistics, everything else the time since the queue was opened. */
+struct ExchangeTimingStatistics
+{
+	uint32 blocksReceived {0};
+	// gaps in the sequence numbers, blocks which were sent but did not arrive
+	uint32 blocksMissing {0};
+
+	// from sending a block to receiving it, in milliseconds
+	double meanExchangeLatency {0.};
+	double maxExchangeLatency {0.};
+	// from processing the first sample of a block to receiving it, includes filling the block
+	double meanEndToEndLatency {0.};
+	double maxEndToEndLatency {0.};
+
+	// speed of the sample clock against the steady clock, in parts per million, and the number
+	// of seconds it was measured over
+	double drift {0.};
+	double driftDuration {0.};
+
+	// of the first sample of the latest block
+	uint64 samplePosition {0};
+	bool hasProjectPosition {false};
+	int64 projectSamplePosition {0};
+	// the project position of the playing transport did not advance with the samples, by loops or
+	// locates of the host
+	uint32 transportJumps {0};
+};
+
+//------------------------------------------------------------------------
+/** Measures the exchange latency and the clock drift from the timestamps of the DataBlocks.
+ *
+ *	The blocks are timed on the thread which receives them, before any queueing of the controller,
+ *	the UI thread picks up the latest statistics with a timer. */
+class ExchangeTimingTracker
+{
+public:
+	/** Not thread safe, call before the blocks of a new queue arrive. */
+	void reset (uint32 resultRate);
+
+	/** Called by the thread which receives the blocks, receiveTime from getSteadyTime. */
+	void onBlockReceived (const DataBlock* block, int64 receiveTime);
+	/** Returns false if there are no new statistics, called by the UI thread. */
+	bool getLatestStatistics (ExchangeTimingStatistics& statistics)
+	{
+		return results.read (statistics);
+	}
+
+//------------------------------------------------------------------------
+private:
+	void updateDrift (const DataBlock* block);
+	void publish (int64 receiveTime);
+
+	ExchangeTimingStatistics current;
+	int64 publishInterval {0};
+	int64 lastPublishTime {0};
+	uint32 intervalBlocks {0};
+	double exchangeLatencySum {0.};
+	double endToEndLatencySum {0.};
+
+	bool hasPreviousBlock {false};
+	uint32 previousSequence {0};
+	uint64 previousPosition {0};
+	int64 previousProjectPosition {0};
+	uint32 previousTimestampFlags {0};
+
+	// the drift is measured from the first block of a continuous stream
+	bool hasDriftStart {false};
+	uint32 driftSampleRate {0};
+	uint64 driftStartPosition {0};
+	int64 driftStartTime {0};
+
+	TripleBuffer<ExchangeTimingStatistics> results;
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
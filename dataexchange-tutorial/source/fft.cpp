@@ -0,0 +1,246 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "fft.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TUTORIAL_FFT_SSE2 1
+#include <emmintrin.h>
+#else
+#define TUTORIAL_FFT_SSE2 0
+#endif
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+//------------------------------------------------------------------------
+inline uint32 getFirstRadix4Span (uint32 halfSize)
+{
+	// one radix-2 stage first if log2 (halfSize) is odd
+	uint32 log2Size = 0;
+	while ((1u << log2Size) < halfSize)
+		++log2Size;
+	return (log2Size & 1) ? 2 : 1;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+bool FFT::setup (uint32 newSize, Implementation implementation)
+{
+	if (newSize < kMinSize || newSize > kMaxSize || (newSize & (newSize - 1)) != 0)
+		return false;
+
+	size = newSize;
+	halfSize = size / 2;
+	useSIMD = implementation == Implementation::SIMD && TUTORIAL_FFT_SSE2;
+
+	uint32 numBits = 0;
+	while ((1u << numBits) < halfSize)
+		++numBits;
+	bitReversal.resize (halfSize);
+	for (auto index = 0u; index < halfSize; ++index)
+	{
+		uint32 reversed = 0;
+		for (auto bit = 0u; bit < numBits; ++bit)
+			reversed |= ((index >> bit) & 1) << (numBits - 1 - bit);
+		bitReversal[index] = reversed;
+	}
+
+	stageTwiddles.clear ();
+	for (auto span = getFirstRadix4Span (halfSize); span * 4 <= halfSize; span *= 4)
+	{
+		auto offset = stageTwiddles.size ();
+		stageTwiddles.resize (offset + span * 4);
+		auto twiddles = stageTwiddles.data () + offset;
+		for (auto j = 0u; j < span; ++j)
+		{
+			twiddles[j] = static_cast<float> (std::cos (kPi * j / span));
+			twiddles[span + j] = static_cast<float> (-std::sin (kPi * j / span));
+			twiddles[span * 2 + j] = static_cast<float> (std::cos (kPi * j / (2. * span)));
+			twiddles[span * 3 + j] = static_cast<float> (-std::sin (kPi * j / (2. * span)));
+		}
+	}
+
+	splitCos.resize (halfSize + 1);
+	splitSin.resize (halfSize + 1);
+	for (auto k = 0u; k <= halfSize; ++k)
+	{
+		splitCos[k] = static_cast<float> (std::cos (2. * kPi * k / size));
+		splitSin[k] = static_cast<float> (-std::sin (2. * kPi * k / size));
+	}
+
+	workReal.assign (halfSize, 0.f);
+	workImag.assign (halfSize, 0.f);
+	return true;
+}
+
+//------------------------------------------------------------------------
+void FFT::forward (const float* input, float* real, float* imag)
+{
+	// even samples are the real, odd samples the imaginary part of the half size transform
+	for (auto index = 0u; index < halfSize; ++index)
+	{
+		auto source = bitReversal[index] * 2;
+		workReal[index] = input[source];
+		workImag[index] = input[source + 1];
+	}
+	complexTransform ();
+
+	// split into the spectra of the even and the odd samples and combine them
+	for (auto k = 0u; k <= halfSize; ++k)
+	{
+		auto first = k == halfSize ? 0 : k;
+		auto second = k == 0 ? 0 : halfSize - k;
+		auto evenReal = (workReal[first] + workReal[second]) * 0.5f;
+		auto evenImag = (workImag[first] - workImag[second]) * 0.5f;
+		auto oddReal = (workImag[first] + workImag[second]) * 0.5f;
+		auto oddImag = (workReal[second] - workReal[first]) * 0.5f;
+		real[k] = evenReal + splitCos[k] * oddReal - splitSin[k] * oddImag;
+		imag[k] = evenImag + splitCos[k] * oddImag + splitSin[k] * oddReal;
+	}
+}
+
+//------------------------------------------------------------------------
+void FFT::complexTransform ()
+{
+	auto span = getFirstRadix4Span (halfSize);
+	if (span == 2)
+		radix2Stage ();
+	auto twiddles = stageTwiddles.data ();
+	for (; span * 4 <= halfSize; span *= 4)
+	{
+		if (useSIMD && span >= 4)
+			radix4StageSIMD (span, twiddles);
+		else
+			radix4Stage (span, twiddles);
+		twiddles += span * 4;
+	}
+}
+
+//------------------------------------------------------------------------
+void FFT::radix2Stage ()
+{
+	for (auto index = 0u; index < halfSize; index += 2)
+	{
+		auto real = workReal[index + 1];
+		auto imag = workImag[index + 1];
+		workReal[index + 1] = workReal[index] - real;
+		workImag[index + 1] = workImag[index] - imag;
+		workReal[index] += real;
+		workImag[index] += imag;
+	}
+}
+
+//------------------------------------------------------------------------
+void FFT::radix4Stage (uint32 span, const float* twiddles)
+{
+	auto w1Cos = twiddles;
+	auto w1Sin = twiddles + span;
+	auto w2Cos = twiddles + span * 2;
+	auto w2Sin = twiddles + span * 3;
+	for (auto group = 0u; group < halfSize; group += span * 4)
+	{
+		auto re = workReal.data () + group;
+		auto im = workImag.data () + group;
+		for (auto j = 0u; j < span; ++j)
+		{
+			auto i0 = j;
+			auto i1 = j + span;
+			auto i2 = j + span * 2;
+			auto i3 = j + span * 3;
+
+			// first radix-2 stage: (0, 1) and (2, 3) with w1
+			auto t1Real = w1Cos[j] * re[i1] - w1Sin[j] * im[i1];
+			auto t1Imag = w1Cos[j] * im[i1] + w1Sin[j] * re[i1];
+			auto t3Real = w1Cos[j] * re[i3] - w1Sin[j] * im[i3];
+			auto t3Imag = w1Cos[j] * im[i3] + w1Sin[j] * re[i3];
+			auto b0Real = re[i0] + t1Real;
+			auto b0Imag = im[i0] + t1Imag;
+			auto b1Real = re[i0] - t1Real;
+			auto b1Imag = im[i0] - t1Imag;
+			auto b2Real = re[i2] + t3Real;
+			auto b2Imag = im[i2] + t3Imag;
+			auto b3Real = re[i2] - t3Real;
+			auto b3Imag = im[i2] - t3Imag;
+
+			// second radix-2 stage: (0, 2) with w2 and (1, 3) with -i * w2
+			auto u2Real = w2Cos[j] * b2Real - w2Sin[j] * b2Imag;
+			auto u2Imag = w2Cos[j] * b2Imag + w2Sin[j] * b2Real;
+			auto u3Real = w2Cos[j] * b3Imag + w2Sin[j] * b3Real;
+			auto u3Imag = -(w2Cos[j] * b3Real - w2Sin[j] * b3Imag);
+			re[i0] = b0Real + u2Real;
+			im[i0] = b0Imag + u2Imag;
+			re[i2] = b0Real - u2Real;
+			im[i2] = b0Imag - u2Imag;
+			re[i1] = b1Real + u3Real;
+			im[i1] = b1Imag + u3Imag;
+			re[i3] = b1Real - u3Real;
+			im[i3] = b1Imag - u3Imag;
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+void FFT::radix4StageSIMD (uint32 span, const float* twiddles)
+{
+#if TUTORIAL_FFT_SSE2
+	for (auto group = 0u; group < halfSize; group += span * 4)
+	{
+		auto re = workReal.data () + group;
+		auto im = workImag.data () + group;
+		for (auto j = 0u; j < span; j += 4)
+		{
+			auto w1Cos = _mm_loadu_ps (twiddles + j);
+			auto w1Sin = _mm_loadu_ps (twiddles + span + j);
+			auto w2Cos = _mm_loadu_ps (twiddles + span * 2 + j);
+			auto w2Sin = _mm_loadu_ps (twiddles + span * 3 + j);
+			auto a0Real = _mm_loadu_ps (re + j);
+			auto a0Imag = _mm_loadu_ps (im + j);
+			auto a1Real = _mm_loadu_ps (re + j + span);
+			auto a1Imag = _mm_loadu_ps (im + j + span);
+			auto a2Real = _mm_loadu_ps (re + j + span * 2);
+			auto a2Imag = _mm_loadu_ps (im + j + span * 2);
+			auto a3Real = _mm_loadu_ps (re + j + span * 3);
+			auto a3Imag = _mm_loadu_ps (im + j + span * 3);
+
+			auto t1Real = _mm_sub_ps (_mm_mul_ps (w1Cos, a1Real), _mm_mul_ps (w1Sin, a1Imag));
+			auto t1Imag = _mm_add_ps (_mm_mul_ps (w1Cos, a1Imag), _mm_mul_ps (w1Sin, a1Real));
+			auto t3Real = _mm_sub_ps (_mm_mul_ps (w1Cos, a3Real), _mm_mul_ps (w1Sin, a3Imag));
+			auto t3Imag = _mm_add_ps (_mm_mul_ps (w1Cos, a3Imag), _mm_mul_ps (w1Sin, a3Real));
+			auto b0Real = _mm_add_ps (a0Real, t1Real);
+			auto b0Imag = _mm_add_ps (a0Imag, t1Imag);
+			auto b1Real = _mm_sub_ps (a0Real, t1Real);
+			auto b1Imag = _mm_sub_ps (a0Imag, t1Imag);
+			auto b2Real = _mm_add_ps (a2Real, t3Real);
+			auto b2Imag = _mm_add_ps (a2Imag, t3Imag);
+			auto b3Real = _mm_sub_ps (a2Real, t3Real);
+			auto b3Imag = _mm_sub_ps (a2Imag, t3Imag);
+
+			auto u2Real = _mm_sub_ps (_mm_mul_ps (w2Cos, b2Real), _mm_mul_ps (w2Sin, b2Imag));
+			auto u2Imag = _mm_add_ps (_mm_mul_ps (w2Cos, b2Imag), _mm_mul_ps (w2Sin, b2Real));
+			auto u3Real = _mm_add_ps (_mm_mul_ps (w2Cos, b3Imag), _mm_mul_ps (w2Sin, b3Real));
+			auto u3Imag = _mm_sub_ps (_mm_mul_ps (w2Sin, b3Imag), _mm_mul_ps (w2Cos, b3Real));
+			_mm_storeu_ps (re + j, _mm_add_ps (b0Real, u2Real));
+			_mm_storeu_ps (im + j, _mm_add_ps (b0Imag, u2Imag));
+			_mm_storeu_ps (re + j + span * 2, _mm_sub_ps (b0Real, u2Real));
+			_mm_storeu_ps (im + j + span * 2, _mm_sub_ps (b0Imag, u2Imag));
+			_mm_storeu_ps (re + j + span, _mm_add_ps (b1Real, u3Real));
+			_mm_storeu_ps (im + j + span, _mm_add_ps (b1Imag, u3Imag));
+			_mm_storeu_ps (re + j + span * 3, _mm_sub_ps (b1Real, u3Real));
+			_mm_storeu_ps (im + j + span * 3, _mm_sub_ps (b1Imag, u3Imag));
+		}
+	}
+#else
+	radix4Stage (span, twiddles);
+#endif
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/base/ftypes.h"
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+/** Real to complex FFT for power of two sizes.
+ *
+ *	A real transform of size N runs a complex transform of size N/2 on the even and odd samples and
+ *	splits the result. The complex transform uses radix-4 stages (two fused radix-2 stages) after a
+ *	bit reversal permutation, plus one radix-2 stage if log2 (N/2) is odd. Real and imaginary parts
+ *	are stored in separate arrays, so the butterflies of four groups run in one SSE2 vector on
+ *	x86-64. setup allocates the twiddle factors and the work buffers, forward does not allocate.
+ */
+class FFT
+{
+public:
+	enum class Implementation
+	{
+		Scalar,
+		SIMD,
+	};
+
+	static constexpr uint32 kMinSize = 16;
+	static constexpr uint32 kMaxSize = 65536;
+
+	/** size must be a power of two between kMinSize and kMaxSize. */
+	bool setup (uint32 size, Implementation implementation = Implementation::SIMD);
+	uint32 getSize () const { return size; }
+
+	/** Transforms size real samples into size / 2 + 1 complex bins. */
+	void forward (const float* input, float* real, float* imag);
+
+//------------------------------------------------------------------------
+private:
+	void complexTransform ();
+	void radix2Stage ();
+	void radix4Stage (uint32 span, const float* twiddles);
+	void radix4StageSIMD (uint32 span, const float* twiddles);
+
+	uint32 size {0};
+	uint32 halfSize {0};
+	bool useSIMD {false};
+	std::vector<uint32> bitReversal;
+	// per radix-4 stage: cos and sin of w1 = W(2L)^j and w2 = W(4L)^j for j < L
+	std::vector<float> stageTwiddles;
+	// W(N)^k for the split of the real transform
+	std::vector<float> splitCos;
+	std::vector<float> splitSin;
+	std::vector<float> workReal;
+	std::vector<float> workImag;
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,304 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "loudness.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TUTORIAL_LOUDNESS_SSE2 1
+#include <emmintrin.h>
+#else
+#define TUTORIAL_LOUDNESS_SSE2 0
+#endif
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kAbsoluteGate = -70.;
+constexpr double kRelativeGate = -10.;
+constexpr double kHistogramResolution = 10.; // bins per LU
+
+//------------------------------------------------------------------------
+double toLoudness (double energy)
+{
+	if (energy <= 0.)
+		return LoudnessMeter::kSilence;
+	return -0.691 + 10. * std::log10 (energy);
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+void LoudnessMeter::setup (double newSampleRate, uint32 numChannels)
+{
+	sampleRate = newSampleRate;
+
+	// K-weighting: high shelf and high pass of BS.1770, derived for the sample rate
+	auto K = std::tan (kPi * 1681.974450955533 / sampleRate);
+	auto Q = 0.7071752369554196;
+	auto Vh = std::pow (10., 3.999843853973347 / 20.);
+	auto Vb = std::pow (Vh, 0.4996667741545416);
+	auto a0 = 1. + K / Q + K * K;
+	stages[0] = {(Vh + Vb * K / Q + K * K) / a0, 2. * (K * K - Vh) / a0,
+	             (Vh - Vb * K / Q + K * K) / a0, 2. * (K * K - 1.) / a0, (1. - K / Q + K * K) / a0};
+	K = std::tan (kPi * 38.13547087602444 / sampleRate);
+	Q = 0.5003270373238773;
+	a0 = 1. + K / Q + K * K;
+	stages[1] = {1., -2., 1., 2. * (K * K - 1.) / a0, (1. - K / Q + K * K) / a0};
+
+	// windowed sinc interpolation filter, every phase has unity gain at DC
+	constexpr auto kNumTaps = kNumTruePeakTaps * kTruePeakOversampling;
+	for (auto phase = 0u; phase < kTruePeakOversampling; ++phase)
+	{
+		double sum = 0.;
+		std::array<double, kNumTruePeakTaps> taps;
+		for (auto tap = 0u; tap < kNumTruePeakTaps; ++tap)
+		{
+			auto index = tap * kTruePeakOversampling + phase;
+			auto x = (index - (kNumTaps - 1) * 0.5) / kTruePeakOversampling;
+			auto sinc = x == 0. ? 1. : std::sin (kPi * x) / (kPi * x);
+			auto window = 0.42 - 0.5 * std::cos (2. * kPi * (index + 0.5) / kNumTaps) +
+			              0.08 * std::cos (4. * kPi * (index + 0.5) / kNumTaps);
+			taps[tap] = sinc * window;
+			sum += taps[tap];
+		}
+		// reversed, so the filter runs forward over the history
+		auto& coefficients = truePeakFilter[phase];
+		for (auto tap = 0u; tap < kNumTruePeakTaps; ++tap)
+			coefficients[kNumTruePeakTaps - 1 - tap] = static_cast<float> (taps[tap] / sum);
+	}
+
+	subBlockSize = std::max<uint32> (static_cast<uint32> (std::lround (sampleRate * 0.1)), 1);
+	channels.assign (numChannels, {});
+	reset ();
+}
+
+//------------------------------------------------------------------------
+void LoudnessMeter::reset ()
+{
+	for (auto& channel : channels)
+	{
+		auto weight = channel.weight;
+		channel = {};
+		channel.weight = weight;
+	}
+	subBlockEnergy = 0.;
+	subBlockPosition = 0;
+	subBlocks.fill (0.);
+	subBlockIndex = 0;
+	numSubBlocks = 0;
+	histogramCounts.fill (0);
+	histogramEnergy.fill (0.);
+	maxTruePeak = 0.f;
+}
+
+//------------------------------------------------------------------------
+void LoudnessMeter::setChannelWeight (uint32 channel, double weight)
+{
+	if (channel < channels.size ())
+		channels[channel].weight = weight;
+}
+
+//------------------------------------------------------------------------
+void LoudnessMeter::process (const float* const* samples, uint32 numSamples)
+{
+	for (auto index = 0u; index < channels.size (); ++index)
+		measureTruePeak (channels[index], samples[index], numSamples);
+
+	uint32 numSamplesDone = 0;
+	while (numSamplesDone < numSamples)
+	{
+		auto count = std::min (subBlockSize - subBlockPosition, numSamples - numSamplesDone);
+		for (auto index = 0u; index < channels.size (); ++index)
+		{
+			auto channelSamples = samples[index] ? samples[index] + numSamplesDone : nullptr;
+			filterChannel (channels[index], channelSamples, count);
+		}
+		subBlockPosition += count;
+		numSamplesDone += count;
+		if (subBlockPosition == subBlockSize)
+			finishSubBlock ();
+	}
+}
+
+//------------------------------------------------------------------------
+void LoudnessMeter::filterChannel (Channel& channel, const float* samples, uint32 numSamples)
+{
+	const auto& s0 = stages[0];
+	const auto& s1 = stages[1];
+	auto z1a = channel.z1[0];
+	auto z2a = channel.z2[0];
+	auto z1b = channel.z1[1];
+	auto z2b = channel.z2[1];
+	double energy = 0.;
+	for (auto index = 0u; index < numSamples; ++index)
+	{
+		double x = samples ? samples[index] : 0.f;
+		auto y = s0.b0 * x + z1a;
+		z1a = s0.b1 * x - s0.a1 * y + z2a;
+		z2a = s0.b2 * x - s0.a2 * y;
+		x = y;
+		y = s1.b0 * x + z1b;
+		z1b = s1.b1 * x - s1.a1 * y + z2b;
+		z2b = s1.b2 * x - s1.a2 * y;
+		energy += y * y;
+	}
+	channel.z1[0] = z1a;
+	channel.z2[0] = z2a;
+	channel.z1[1] = z1b;
+	channel.z2[1] = z2b;
+	subBlockEnergy += channel.weight * energy;
+}
+
+//------------------------------------------------------------------------
+void LoudnessMeter::measureTruePeak (Channel& channel, const float* samples, uint32 numSamples)
+{
+	constexpr auto kHistorySize = kNumTruePeakTaps - 1;
+	auto& history = channel.history;
+	auto peak = channel.truePeak;
+	for (uint32 chunkStart = 0; chunkStart < numSamples; chunkStart += kTruePeakChunkSize)
+	{
+		auto count = std::min (kTruePeakChunkSize, numSamples - chunkStart);
+		if (samples)
+			std::copy_n (samples + chunkStart, count, history.data () + kHistorySize);
+		else
+			std::fill_n (history.data () + kHistorySize, count, 0.f);
+
+		uint32 index = 0;
+#if TUTORIAL_LOUDNESS_SSE2
+		// four output samples of every phase at once
+		const auto signMask = _mm_castsi128_ps (_mm_set1_epi32 (0x7FFFFFFF));
+		auto peakVector = _mm_set1_ps (peak);
+		for (; index + 4 <= count; index += 4)
+		{
+			auto phase0 = _mm_setzero_ps ();
+			auto phase1 = _mm_setzero_ps ();
+			auto phase2 = _mm_setzero_ps ();
+			auto phase3 = _mm_setzero_ps ();
+			for (auto tap = 0u; tap < kNumTruePeakTaps; ++tap)
+			{
+				auto x = _mm_loadu_ps (history.data () + index + tap);
+				phase0 = _mm_add_ps (phase0, _mm_mul_ps (_mm_set1_ps (truePeakFilter[0][tap]), x));
+				phase1 = _mm_add_ps (phase1, _mm_mul_ps (_mm_set1_ps (truePeakFilter[1][tap]), x));
+				phase2 = _mm_add_ps (phase2, _mm_mul_ps (_mm_set1_ps (truePeakFilter[2][tap]), x));
+				phase3 = _mm_add_ps (phase3, _mm_mul_ps (_mm_set1_ps (truePeakFilter[3][tap]), x));
+			}
+			auto maximum = _mm_and_ps (phase0, signMask);
+			maximum = _mm_max_ps (maximum, _mm_and_ps (phase1, signMask));
+			maximum = _mm_max_ps (maximum, _mm_and_ps (phase2, signMask));
+			maximum = _mm_max_ps (maximum, _mm_and_ps (phase3, signMask));
+			peakVector = _mm_max_ps (peakVector, maximum);
+		}
+		peakVector = _mm_max_ps (peakVector, _mm_shuffle_ps (peakVector, peakVector, 0x4E));
+		peakVector = _mm_max_ps (peakVector, _mm_shuffle_ps (peakVector, peakVector, 0xB1));
+		peak = _mm_cvtss_f32 (peakVector);
+#endif
+		for (; index < count; ++index)
+		{
+			for (const auto& phase : truePeakFilter)
+			{
+				float y = 0.f;
+				for (auto tap = 0u; tap < kNumTruePeakTaps; ++tap)
+					y += phase[tap] * history[index + tap];
+				peak = std::max (peak, std::abs (y));
+			}
+		}
+		std::copy_n (history.data () + count, kHistorySize, history.data ());
+	}
+	channel.truePeak = peak;
+	maxTruePeak = std::max (maxTruePeak, peak);
+}
+
+//------------------------------------------------------------------------
+void LoudnessMeter::finishSubBlock ()
+{
+	subBlocks[subBlockIndex] = subBlockEnergy / subBlockSize;
+	subBlockIndex = (subBlockIndex + 1) % kNumSubBlocksShortTerm;
+	numSubBlocks = std::min (numSubBlocks + 1, kNumSubBlocksShortTerm);
+	subBlockEnergy = 0.;
+	subBlockPosition = 0;
+
+	// a new gating block of 400 ms every 100 ms
+	if (numSubBlocks < kNumSubBlocksMomentary)
+		return;
+	auto energy = getMeanEnergy (kNumSubBlocksMomentary);
+	auto loudness = toLoudness (energy);
+	if (loudness <= kAbsoluteGate)
+		return;
+	auto bin = static_cast<uint32> ((loudness - kAbsoluteGate) * kHistogramResolution);
+	bin = std::min (bin, kNumHistogramBins - 1);
+	++histogramCounts[bin];
+	histogramEnergy[bin] += energy;
+}
+
+//------------------------------------------------------------------------
+double LoudnessMeter::getMeanEnergy (uint32 count) const
+{
+	count = std::min (count, numSubBlocks);
+	if (count == 0)
+		return 0.;
+	double sum = 0.;
+	for (auto index = 1u; index <= count; ++index)
+		sum += subBlocks[(subBlockIndex + kNumSubBlocksShortTerm - index) % kNumSubBlocksShortTerm];
+	return sum / count;
+}
+
+//------------------------------------------------------------------------
+double LoudnessMeter::getMomentaryLoudness () const
+{
+	if (numSubBlocks < kNumSubBlocksMomentary)
+		return kSilence;
+	return toLoudness (getMeanEnergy (kNumSubBlocksMomentary));
+}
+
+//------------------------------------------------------------------------
+double LoudnessMeter::getShortTermLoudness () const
+{
+	// uses the available sub-blocks during the first three seconds
+	if (numSubBlocks < kNumSubBlocksMomentary)
+		return kSilence;
+	return toLoudness (getMeanEnergy (kNumSubBlocksShortTerm));
+}
+
+//------------------------------------------------------------------------
+double LoudnessMeter::getIntegratedLoudness () const
+{
+	double energy = 0.;
+	uint64 count = 0;
+	for (auto bin = 0u; bin < kNumHistogramBins; ++bin)
+	{
+		energy += histogramEnergy[bin];
+		count += histogramCounts[bin];
+	}
+	if (count == 0)
+		return kSilence;
+
+	// the relative gate is resolved to the bin which contains it
+	auto gate = toLoudness (energy / count) + kRelativeGate;
+	auto firstBin = std::max (0., (gate - kAbsoluteGate) * kHistogramResolution);
+	energy = 0.;
+	count = 0;
+	for (auto bin = static_cast<uint32> (firstBin); bin < kNumHistogramBins; ++bin)
+	{
+		energy += histogramEnergy[bin];
+		count += histogramCounts[bin];
+	}
+	return count > 0 ? toLoudness (energy / count) : kSilence;
+}
+
+//------------------------------------------------------------------------
+float LoudnessMeter::takeTruePeak (uint32 channel)
+{
+	if (channel >= channels.size ())
+		return 0.f;
+	return std::exchange (channels[channel].truePeak, 0.f);
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
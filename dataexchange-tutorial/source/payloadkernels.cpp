@@ -0,0 +1,443 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "payloadkernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TUTORIAL_PAYLOADKERNEL_SSE2 1
+#include <emmintrin.h>
+#else
+#define TUTORIAL_PAYLOADKERNEL_SSE2 0
+#endif
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+//------------------------------------------------------------------------
+inline int16_t toInt16 (float sample)
+{
+	sample = std::min (std::max (sample, -1.f), 1.f);
+	return static_cast<int16_t> (std::lrint (sample * 32767.f));
+}
+
+#if TUTORIAL_PAYLOADKERNEL_SSE2
+//------------------------------------------------------------------------
+inline float horizontalMin (__m128 value)
+{
+	value = _mm_min_ps (value, _mm_shuffle_ps (value, value, _MM_SHUFFLE (1, 0, 3, 2)));
+	value = _mm_min_ps (value, _mm_shuffle_ps (value, value, _MM_SHUFFLE (2, 3, 0, 1)));
+	return _mm_cvtss_f32 (value);
+}
+
+//------------------------------------------------------------------------
+inline float horizontalMax (__m128 value)
+{
+	value = _mm_max_ps (value, _mm_shuffle_ps (value, value, _MM_SHUFFLE (1, 0, 3, 2)));
+	value = _mm_max_ps (value, _mm_shuffle_ps (value, value, _MM_SHUFFLE (2, 3, 0, 1)));
+	return _mm_cvtss_f32 (value);
+}
+
+//------------------------------------------------------------------------
+inline float horizontalSum (__m128 value)
+{
+	value = _mm_add_ps (value, _mm_shuffle_ps (value, value, _MM_SHUFFLE (1, 0, 3, 2)));
+	value = _mm_add_ps (value, _mm_shuffle_ps (value, value, _MM_SHUFFLE (2, 3, 0, 1)));
+	return _mm_cvtss_f32 (value);
+}
+
+//------------------------------------------------------------------------
+template <bool Aligned>
+inline __m128 loadSamples (const float* samples)
+{
+	if constexpr (Aligned)
+		return _mm_load_ps (samples);
+	else
+		return _mm_loadu_ps (samples);
+}
+
+//------------------------------------------------------------------------
+/** Four doubles converted to float, two conversions and one shuffle. */
+template <bool Aligned>
+inline __m128 loadSamples (const double* samples)
+{
+	__m128d low;
+	__m128d high;
+	if constexpr (Aligned)
+	{
+		low = _mm_load_pd (samples);
+		high = _mm_load_pd (samples + 2);
+	}
+	else
+	{
+		low = _mm_loadu_pd (samples);
+		high = _mm_loadu_pd (samples + 2);
+	}
+	return _mm_movelh_ps (_mm_cvtpd_ps (low), _mm_cvtpd_ps (high));
+}
+
+//------------------------------------------------------------------------
+/** Four frames of a channel, zeros for a silent one. */
+template <typename SampleType>
+inline __m128 loadFrames (const SampleType* channel, int32 frame)
+{
+	return channel ? loadSamples<false> (channel + frame) : _mm_setzero_ps ();
+}
+
+//------------------------------------------------------------------------
+/** Reduces numVectors * 4 samples, returns the number of samples. */
+template <bool Aligned, typename SampleType>
+int32 accumulateVectors (const SampleType* input, int32 numVectors, float& minValue,
+                         float& maxValue, float& sumOfSquares)
+{
+	auto minVector = _mm_set1_ps (minValue);
+	auto maxVector = _mm_set1_ps (maxValue);
+	auto sumVector = _mm_setzero_ps ();
+	for (auto vectorIndex = 0; vectorIndex < numVectors; ++vectorIndex)
+	{
+		auto samples = loadSamples<Aligned> (input + vectorIndex * 4);
+		minVector = _mm_min_ps (minVector, samples);
+		maxVector = _mm_max_ps (maxVector, samples);
+		sumVector = _mm_add_ps (sumVector, _mm_mul_ps (samples, samples));
+	}
+	minValue = horizontalMin (minVector);
+	maxValue = horizontalMax (maxVector);
+	sumOfSquares += horizontalSum (sumVector);
+	return numVectors * 4;
+}
+
+//------------------------------------------------------------------------
+/** Sums numVectors * 4 frames of both channels, returns the number of frames. */
+template <typename SampleType>
+int32 accumulateStereoVectors (const SampleType* left, const SampleType* right, int32 numVectors,
+                               StereoAccumulator& accumulator)
+{
+	// two sets of sums, so the additions of consecutive vectors do not wait for each other
+	auto leftSum0 = _mm_setzero_ps ();
+	auto rightSum0 = _mm_setzero_ps ();
+	auto productSum0 = _mm_setzero_ps ();
+	auto leftSum1 = _mm_setzero_ps ();
+	auto rightSum1 = _mm_setzero_ps ();
+	auto productSum1 = _mm_setzero_ps ();
+	auto vectorIndex = 0;
+	for (; vectorIndex + 2 <= numVectors; vectorIndex += 2)
+	{
+		auto left0 = loadFrames (left, vectorIndex * 4);
+		auto right0 = loadFrames (right, vectorIndex * 4);
+		auto left1 = loadFrames (left, vectorIndex * 4 + 4);
+		auto right1 = loadFrames (right, vectorIndex * 4 + 4);
+		leftSum0 = _mm_add_ps (leftSum0, _mm_mul_ps (left0, left0));
+		rightSum0 = _mm_add_ps (rightSum0, _mm_mul_ps (right0, right0));
+		productSum0 = _mm_add_ps (productSum0, _mm_mul_ps (left0, right0));
+		leftSum1 = _mm_add_ps (leftSum1, _mm_mul_ps (left1, left1));
+		rightSum1 = _mm_add_ps (rightSum1, _mm_mul_ps (right1, right1));
+		productSum1 = _mm_add_ps (productSum1, _mm_mul_ps (left1, right1));
+	}
+	if (vectorIndex < numVectors)
+	{
+		auto left0 = loadFrames (left, vectorIndex * 4);
+		auto right0 = loadFrames (right, vectorIndex * 4);
+		leftSum0 = _mm_add_ps (leftSum0, _mm_mul_ps (left0, left0));
+		rightSum0 = _mm_add_ps (rightSum0, _mm_mul_ps (right0, right0));
+		productSum0 = _mm_add_ps (productSum0, _mm_mul_ps (left0, right0));
+	}
+	accumulator.sumLeft += horizontalSum (_mm_add_ps (leftSum0, leftSum1));
+	accumulator.sumRight += horizontalSum (_mm_add_ps (rightSum0, rightSum1));
+	accumulator.sumProduct += horizontalSum (_mm_add_ps (productSum0, productSum1));
+	return numVectors * 4;
+}
+#endif // TUTORIAL_PAYLOADKERNEL_SSE2
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void interleaveSamples (const SampleType* const* inputs, int32 numChannels, int32 numSamples,
+                        float* output)
+{
+	auto sampleIndex = 0;
+	// channels below firstChannel are done up to transposedFrames
+	auto firstChannel = 0;
+	auto transposedFrames = 0;
+#if TUTORIAL_PAYLOADKERNEL_SSE2
+	// the common stereo case writes two frames per unpack
+	if (numChannels == 2 && inputs[0] && inputs[1])
+	{
+		for (; sampleIndex + 4 <= numSamples; sampleIndex += 4)
+		{
+			auto left = loadSamples<false> (inputs[0] + sampleIndex);
+			auto right = loadSamples<false> (inputs[1] + sampleIndex);
+			_mm_storeu_ps (output + sampleIndex * 2, _mm_unpacklo_ps (left, right));
+			_mm_storeu_ps (output + sampleIndex * 2 + 4, _mm_unpackhi_ps (left, right));
+		}
+	}
+	// larger layouts transpose groups of four channels and four frames
+	else if (numChannels >= 4)
+	{
+		transposedFrames = numSamples & ~3;
+		for (; firstChannel + 4 <= numChannels; firstChannel += 4)
+		{
+			auto channels = inputs + firstChannel;
+			for (auto frame = 0; frame < transposedFrames; frame += 4)
+			{
+				auto row0 = loadFrames (channels[0], frame);
+				auto row1 = loadFrames (channels[1], frame);
+				auto row2 = loadFrames (channels[2], frame);
+				auto row3 = loadFrames (channels[3], frame);
+				_MM_TRANSPOSE4_PS (row0, row1, row2, row3);
+				auto destination = output + frame * numChannels + firstChannel;
+				_mm_storeu_ps (destination, row0);
+				_mm_storeu_ps (destination + numChannels, row1);
+				_mm_storeu_ps (destination + numChannels * 2, row2);
+				_mm_storeu_ps (destination + numChannels * 3, row3);
+			}
+		}
+	}
+#endif
+	for (auto channel = 0; channel < numChannels; ++channel)
+	{
+		auto input = inputs[channel];
+		auto frame = channel < firstChannel ? transposedFrames : sampleIndex;
+		for (; frame < numSamples; ++frame)
+			output[frame * numChannels + channel] = input ? static_cast<float> (input[frame]) : 0.f;
+	}
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void convertSamplesToInt16 (const SampleType* input, int32 numSamples, int16_t* output)
+{
+	if (!input)
+	{
+		std::fill (output, output + numSamples, int16_t {0});
+		return;
+	}
+	auto sampleIndex = 0;
+#if TUTORIAL_PAYLOADKERNEL_SSE2
+	const auto minusOne = _mm_set1_ps (-1.f);
+	const auto one = _mm_set1_ps (1.f);
+	const auto scale = _mm_set1_ps (32767.f);
+	for (; sampleIndex + 8 <= numSamples; sampleIndex += 8)
+	{
+		auto first = loadSamples<false> (input + sampleIndex);
+		auto second = loadSamples<false> (input + sampleIndex + 4);
+		first = _mm_mul_ps (_mm_min_ps (_mm_max_ps (first, minusOne), one), scale);
+		second = _mm_mul_ps (_mm_min_ps (_mm_max_ps (second, minusOne), one), scale);
+		// round to nearest and pack with signed saturation
+		auto packed = _mm_packs_epi32 (_mm_cvtps_epi32 (first), _mm_cvtps_epi32 (second));
+		_mm_storeu_si128 (reinterpret_cast<__m128i*> (output + sampleIndex), packed);
+	}
+#endif
+	for (; sampleIndex < numSamples; ++sampleIndex)
+		output[sampleIndex] = toInt16 (static_cast<float> (input[sampleIndex]));
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void accumulateSamples (const SampleType* input, int32 numSamples,
+                        DecimationAccumulator& accumulator)
+{
+	if (numSamples <= 0)
+		return;
+	if (!input)
+	{
+		accumulator.min = accumulator.numSamples ? std::min (accumulator.min, 0.f) : 0.f;
+		accumulator.max = accumulator.numSamples ? std::max (accumulator.max, 0.f) : 0.f;
+		accumulator.numSamples += numSamples;
+		return;
+	}
+	auto firstSample = static_cast<float> (input[0]);
+	auto minValue = accumulator.numSamples ? accumulator.min : firstSample;
+	auto maxValue = accumulator.numSamples ? accumulator.max : firstSample;
+	auto sumOfSquares = accumulator.sumOfSquares;
+	auto sampleIndex = 0;
+#if TUTORIAL_PAYLOADKERNEL_SSE2
+	// the channels of a DataBlock start on a cache line
+	if ((reinterpret_cast<uintptr_t> (input) & 15) == 0)
+		sampleIndex = accumulateVectors<true> (input, numSamples / 4, minValue, maxValue,
+		                                       sumOfSquares);
+	else
+		sampleIndex = accumulateVectors<false> (input, numSamples / 4, minValue, maxValue,
+		                                        sumOfSquares);
+#endif
+	for (; sampleIndex < numSamples; ++sampleIndex)
+	{
+		auto sample = static_cast<float> (input[sampleIndex]);
+		minValue = std::min (minValue, sample);
+		maxValue = std::max (maxValue, sample);
+		sumOfSquares += sample * sample;
+	}
+	accumulator.min = minValue;
+	accumulator.max = maxValue;
+	accumulator.sumOfSquares = sumOfSquares;
+	accumulator.numSamples += numSamples;
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void accumulateStereoSamples (const SampleType* left, const SampleType* right, int32 numSamples,
+                              StereoAccumulator& accumulator)
+{
+	if (numSamples <= 0)
+		return;
+	if (accumulator.numSamples == 0)
+	{
+		accumulator.firstLeft = left ? static_cast<float> (left[0]) : 0.f;
+		accumulator.firstRight = right ? static_cast<float> (right[0]) : 0.f;
+	}
+	accumulator.numSamples += numSamples;
+	if (!left && !right)
+		return;
+	auto sampleIndex = 0;
+#if TUTORIAL_PAYLOADKERNEL_SSE2
+	sampleIndex = accumulateStereoVectors (left, right, numSamples / 4, accumulator);
+#endif
+	for (; sampleIndex < numSamples; ++sampleIndex)
+	{
+		auto leftSample = left ? static_cast<float> (left[sampleIndex]) : 0.f;
+		auto rightSample = right ? static_cast<float> (right[sampleIndex]) : 0.f;
+		accumulator.sumLeft += leftSample * leftSample;
+		accumulator.sumRight += rightSample * rightSample;
+		accumulator.sumProduct += leftSample * rightSample;
+	}
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+void interleaveChannels (const float* const* inputs, int32 numChannels, int32 numSamples,
+                         float* output)
+{
+	interleaveSamples (inputs, numChannels, numSamples, output);
+}
+
+//------------------------------------------------------------------------
+void interleaveChannels (const double* const* inputs, int32 numChannels, int32 numSamples,
+                         float* output)
+{
+	interleaveSamples (inputs, numChannels, numSamples, output);
+}
+
+//------------------------------------------------------------------------
+void convertToFloat (const double* input, int32 numSamples, float* output)
+{
+	if (!input)
+	{
+		std::fill (output, output + numSamples, 0.f);
+		return;
+	}
+	auto sampleIndex = 0;
+#if TUTORIAL_PAYLOADKERNEL_SSE2
+	for (; sampleIndex + 8 <= numSamples; sampleIndex += 8)
+	{
+		_mm_storeu_ps (output + sampleIndex, loadSamples<false> (input + sampleIndex));
+		_mm_storeu_ps (output + sampleIndex + 4, loadSamples<false> (input + sampleIndex + 4));
+	}
+#endif
+	for (; sampleIndex < numSamples; ++sampleIndex)
+		output[sampleIndex] = static_cast<float> (input[sampleIndex]);
+}
+
+//------------------------------------------------------------------------
+void convertToInt16 (const float* input, int32 numSamples, int16_t* output)
+{
+	convertSamplesToInt16 (input, numSamples, output);
+}
+
+//------------------------------------------------------------------------
+void convertToInt16 (const double* input, int32 numSamples, int16_t* output)
+{
+	convertSamplesToInt16 (input, numSamples, output);
+}
+
+//------------------------------------------------------------------------
+DecimatedPoint DecimationAccumulator::getPoint () const
+{
+	if (numSamples == 0)
+		return {0.f, 0.f, 0.f};
+	return {min, max, std::sqrt (sumOfSquares / static_cast<float> (numSamples))};
+}
+
+//------------------------------------------------------------------------
+void accumulate (const float* input, int32 numSamples, DecimationAccumulator& accumulator)
+{
+	accumulateSamples (input, numSamples, accumulator);
+}
+
+//------------------------------------------------------------------------
+void accumulate (const double* input, int32 numSamples, DecimationAccumulator& accumulator)
+{
+	accumulateSamples (input, numSamples, accumulator);
+}
+
+//------------------------------------------------------------------------
+DecimatedPoint mergeDecimatedPoints (const DecimatedPoint& first, const DecimatedPoint& second)
+{
+	auto meanSquare = (first.rms * first.rms + second.rms * second.rms) * 0.5f;
+	return {std::min (first.min, second.min), std::max (first.max, second.max),
+	        std::sqrt (meanSquare)};
+}
+
+//------------------------------------------------------------------------
+void accumulateStereo (const float* left, const float* right, int32 numSamples,
+                       StereoAccumulator& accumulator)
+{
+	accumulateStereoSamples (left, right, numSamples, accumulator);
+}
+
+//------------------------------------------------------------------------
+void accumulateStereo (const double* left, const double* right, int32 numSamples,
+                       StereoAccumulator& accumulator)
+{
+	accumulateStereoSamples (left, right, numSamples, accumulator);
+}
+
+//------------------------------------------------------------------------
+void StereoCorrelation::setup (double sampleRate, float integrationTime)
+{
+	*this = {};
+	if (sampleRate > 0. && integrationTime > 0.f)
+		decay = static_cast<float> (std::exp (-1. / (integrationTime * sampleRate)));
+	else
+		decay = 0.f;
+}
+
+//------------------------------------------------------------------------
+StereoPoint StereoCorrelation::addPoint (const StereoAccumulator& accumulator)
+{
+	constexpr auto kSqrtHalf = 0.70710678f;
+	// silence below -120 dB has no correlation
+	constexpr auto kMinEnergy = 1e-12f;
+
+	// all points but the last of an overflow have the same length
+	if (accumulator.numSamples != pointLength)
+	{
+		pointLength = accumulator.numSamples;
+		pointDecay = std::pow (decay, static_cast<float> (pointLength));
+	}
+	sumLeft = sumLeft * pointDecay + accumulator.sumLeft;
+	sumRight = sumRight * pointDecay + accumulator.sumRight;
+	sumProduct = sumProduct * pointDecay + accumulator.sumProduct;
+
+	StereoPoint point {};
+	auto energy = sumLeft * sumRight;
+	if (energy > kMinEnergy * kMinEnergy)
+		point.correlation = std::min (std::max (sumProduct / std::sqrt (energy), -1.f), 1.f);
+	if (accumulator.numSamples > 0)
+	{
+		auto scale = 0.25f / static_cast<float> (accumulator.numSamples);
+		auto sum = accumulator.sumLeft + accumulator.sumRight;
+		// rounding may leave a tiny negative energy
+		point.midEnergy = std::max ((sum + 2.f * accumulator.sumProduct) * scale, 0.f);
+		point.sideEnergy = std::max ((sum - 2.f * accumulator.sumProduct) * scale, 0.f);
+	}
+	point.x = (accumulator.firstRight - accumulator.firstLeft) * kSqrtHalf;
+	point.y = (accumulator.firstLeft + accumulator.firstRight) * kSqrtHalf;
+	return point;
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
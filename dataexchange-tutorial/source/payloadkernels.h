@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "dataexchange.h"
+#include "pluginterfaces/base/ftypes.h"
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+// Kernels writing the payload of a DataBlock from planar float or double input. They use SSE2 on
+// x86-64 and plain loops the compiler can vectorize elsewhere. A nullptr input stands for a silent
+// channel. Double input is converted to float while it is read, with the rounding of a cast.
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+/** Writes numSamples frames of numChannels channels interleaved to output. */
+void interleaveChannels (const float* const* inputs, int32 numChannels, int32 numSamples,
+                         float* output);
+void interleaveChannels (const double* const* inputs, int32 numChannels, int32 numSamples,
+                         float* output);
+
+//------------------------------------------------------------------------
+/** Converts to float, the planar payload of 64-bit processing. */
+void convertToFloat (const double* input, int32 numSamples, float* output);
+
+//------------------------------------------------------------------------
+/** Converts to int16 with rounding and saturation, -1..1 maps to -32767..32767. */
+void convertToInt16 (const float* input, int32 numSamples, int16_t* output);
+void convertToInt16 (const double* input, int32 numSamples, int16_t* output);
+
+//------------------------------------------------------------------------
+/** Running min, max and sum of squares of the samples of the current decimated point. */
+struct DecimationAccumulator
+{
+	float min {0.f};
+	float max {0.f};
+	float sumOfSquares {0.f};
+	uint32 numSamples {0};
+
+	void reset () { *this = {}; }
+	DecimatedPoint getPoint () const;
+};
+
+/** Adds numSamples samples to the accumulator. */
+void accumulate (const float* input, int32 numSamples, DecimationAccumulator& accumulator);
+void accumulate (const double* input, int32 numSamples, DecimationAccumulator& accumulator);
+
+//------------------------------------------------------------------------
+/** Reduces two adjacent points with the same decimation into one. */
+DecimatedPoint mergeDecimatedPoints (const DecimatedPoint& first, const DecimatedPoint& second);
+
+//------------------------------------------------------------------------
+/** Sums of the frames of the current StereoPoint. */
+struct StereoAccumulator
+{
+	// of L * L, R * R and L * R
+	float sumLeft {0.f};
+	float sumRight {0.f};
+	float sumProduct {0.f};
+	// the first frame, the goniometer dot of the point
+	float firstLeft {0.f};
+	float firstRight {0.f};
+	uint32 numSamples {0};
+
+	void reset () { *this = {}; }
+};
+
+/** Adds numSamples frames of the left and right channel to the accumulator. */
+void accumulateStereo (const float* left, const float* right, int32 numSamples,
+                       StereoAccumulator& accumulator);
+void accumulateStereo (const double* left, const double* right, int32 numSamples,
+                       StereoAccumulator& accumulator);
+
+//------------------------------------------------------------------------
+/** Sums of all points so far, fading over the integration time of the correlation meter. */
+struct StereoCorrelation
+{
+	float sumLeft {0.f};
+	float sumRight {0.f};
+	float sumProduct {0.f};
+	// fade of the sums per input sample, and for the length of the last point
+	float decay {1.f};
+	float pointDecay {1.f};
+	uint32 pointLength {0};
+
+	/** Clears the sums, an integration time of 0 seconds makes every point independent. */
+	void setup (double sampleRate, float integrationTime);
+	/** Fades the sums by the length of the point, adds it and returns the point. */
+	StereoPoint addPoint (const StereoAccumulator& accumulator);
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -4,11 +4,29 @@
 
 #include "cids.h"
 #include "processor.h"
+#include "../../common/source/busprocessing.h"
+#include "../../common/source/rtsafetycheck.h"
 
+#include "base/source/fdebug.h"
 #include "base/source/fstreamer.h"
 #include "pluginterfaces/vst/ivstparameterchanges.h"
+#include <algorithm>
 
 namespace Steinberg::Tutorial {
+namespace {
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+inline SampleType** getSampleBuffers (const Vst::AudioBusBuffers& buffers)
+{
+	if constexpr (std::is_same_v<SampleType, Vst::Sample64>)
+		return buffers.channelBuffers64;
+	else
+		return buffers.channelBuffers32;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
 
 //------------------------------------------------------------------------
 // DataExchangeProcessor
@@ -32,6 +50,8 @@ tresult PLUGIN_API DataExchangeProcessor::initialize (FUnknown* context)
 
 	addAudioInput (STR16 ("Stereo In"), Steinberg::Vst::SpeakerArr::kStereo);
 	addAudioOutput (STR16 ("Stereo Out"), Steinberg::Vst::SpeakerArr::kStereo);
+	// only read by StreamSource::Sidechain streams
+	addAudioInput (STR16 ("Sidechain In"), Steinberg::Vst::SpeakerArr::kStereo, Vst::kAux, 0);
 
 	return kResultOk;
 }
@@ -42,22 +62,8 @@ tresult PLUGIN_API DataExchangeProcessor::connect (Vst::IConnectionPoint* other)
 	auto result = Vst::AudioEffect::connect (other);
 	if (result == kResultTrue)
 	{
-		auto configCallback = [this] (Vst::DataExchangeHandler::Config& config,
-		                              const Vst::ProcessSetup& setup) {
-			Vst::SpeakerArrangement arr;
-			getBusArrangement (Vst::BusDirections::kInput, 0, arr);
-			numChannels = static_cast<uint16_t> (Vst::SpeakerArr::getChannelCount (arr));
-			auto sampleSize = sizeof (float);
-
-			config.blockSize = setup.sampleRate * numChannels * sampleSize + sizeof (DataBlock);
-			config.numBlocks = 2;
-			config.alignment = 32;
-			config.userContextID = 0;
-			return true;
-		};
-
-		dataExchange = std::make_unique<Vst::DataExchangeHandler> (this, configCallback);
-		dataExchange->onConnect (other, getHostContext ());
+		connectedPeer = other;
+		createStreams ();
 	}
 	return result;
 }
@@ -65,93 +71,170 @@ tresult PLUGIN_API DataExchangeProcessor::connect (Vst::IConnectionPoint* other)
 //------------------------------------------------------------------------
 tresult PLUGIN_API DataExchangeProcessor::disconnect (Vst::IConnectionPoint* other)
 {
-	if (dataExchange)
+	destroyStreams ();
+	connectedPeer = nullptr;
+	return AudioEffect::disconnect (other);
+}
+
+//------------------------------------------------------------------------
+void DataExchangeProcessor::setStreamingConfigs (std::vector<StreamingConfig> configs)
+{
+	if (configs.empty ())
+		return;
+	streamingConfigs = std::move (configs);
+	// connected already, else the streams are created on connect
+	if (!streams.empty ())
 	{
-		dataExchange->onDisconnect (other);
-		dataExchange.reset ();
+		destroyStreams ();
+		createStreams ();
 	}
-	return AudioEffect::disconnect (other);
+}
+
+//------------------------------------------------------------------------
+const ExchangeStatistics& DataExchangeProcessor::getStatistics (uint32 streamIndex) const
+{
+	static const ExchangeStatistics noStatistics;
+	if (streamIndex >= streams.size ())
+		return noStatistics;
+	return streams[streamIndex]->getStatistics ();
+}
+
+//------------------------------------------------------------------------
+void DataExchangeProcessor::createStreams ()
+{
+	for (auto index = 0u; index < streamingConfigs.size (); ++index)
+	{
+		auto stream = std::make_unique<ExchangeStream> (this, streamingConfigs[index], index);
+		stream->onConnect (connectedPeer, getHostContext ());
+		streams.push_back (std::move (stream));
+	}
+}
+
+//------------------------------------------------------------------------
+void DataExchangeProcessor::destroyStreams ()
+{
+	for (auto& stream : streams)
+		stream->onDisconnect (connectedPeer);
+	streams.clear ();
+}
+
+//------------------------------------------------------------------------
+uint16 DataExchangeProcessor::getChannelCount (StreamSource source)
+{
+	auto direction = source == StreamSource::Output ? Vst::BusDirections::kOutput :
+	                                                  Vst::BusDirections::kInput;
+	auto index = source == StreamSource::Sidechain ? 1 : 0;
+	Vst::SpeakerArrangement arr = 0;
+	if (getBusArrangement (direction, index, arr) != kResultTrue)
+		return 0;
+	return static_cast<uint16> (Vst::SpeakerArr::getChannelCount (arr));
+}
+
+//------------------------------------------------------------------------
+bool DataExchangeProcessor::isSidechainActive ()
+{
+	// the buffers of an inactive bus hold no audio, if the host passes them at all
+	auto bus = getAudioInput (1);
+	return bus && bus->isActive ();
 }
 
 //------------------------------------------------------------------------
 tresult PLUGIN_API DataExchangeProcessor::setActive (TBool state)
 {
 	if (state)
-		dataExchange->onActivate (processSetup);
+	{
+		beginRTViolationReport ();
+		for (auto& stream : streams)
+			stream->onActivate (processSetup, getChannelCount (stream->getConfig ().source));
+	}
 	else
-		dataExchange->onDeactivate ();
+	{
+		for (auto& stream : streams)
+			stream->onDeactivate ();
+		reportRTViolations ("DataExchangeProcessor");
+	}
 	return AudioEffect::setActive (state);
 }
 
 //------------------------------------------------------------------------
 tresult PLUGIN_API DataExchangeProcessor::canProcessSampleSize (int32 symbolicSampleSize)
 {
-	if (symbolicSampleSize == Vst::kSample32)
+	// 64-bit audio passes through at full precision, only the exchange blocks hold float
+	if (symbolicSampleSize == Vst::kSample32 || symbolicSampleSize == Vst::kSample64)
 		return kResultTrue;
 	return kResultFalse;
 }
 
 //------------------------------------------------------------------------
-void DataExchangeProcessor::acquireNewExchangeBlock ()
+void DataExchangeProcessor::updateProcessTiming (const Vst::ProcessContext* context)
+{
+	processTiming.captureTime = getSteadyTime ();
+	processTiming.systemTime = processTiming.captureTime;
+	processTiming.projectPosition = 0;
+	processTiming.flags = 0;
+	if (context == nullptr)
+		return;
+	processTiming.projectPosition = context->projectTimeSamples;
+	processTiming.flags |= kProjectPositionValid;
+	if (context->state & Vst::ProcessContext::kPlaying)
+		processTiming.flags |= kTransportPlaying;
+	if (context->state & Vst::ProcessContext::kSystemTimeValid)
+	{
+		processTiming.systemTime = context->systemTime;
+		processTiming.flags |= kHostSystemTime;
+	}
+}
+
+//------------------------------------------------------------------------
+template <typename SampleType>
+void DataExchangeProcessor::processStreams (Vst::ProcessData& data, bool outputStreams)
 {
-	currentExchangeBlock = dataExchange->getCurrentOrNewBlock ();
-	if (auto block = toDataBlock (currentExchangeBlock))
+	auto numSamples = static_cast<uint32> (data.numSamples);
+	for (auto& stream : streams)
 	{
-		block->sampleRate = static_cast<uint32_t> (processSetup.sampleRate);
-		block->numChannels = numChannels;
-		block->sampleSize = sizeof (float);
-		block->numSamples = 0;
+		auto source = stream->getConfig ().source;
+		if ((source == StreamSource::Output) != outputStreams)
+			continue;
+		const Vst::AudioBusBuffers* bus = nullptr;
+		if (source == StreamSource::Output)
+			bus = &data.outputs[0];
+		else if (source == StreamSource::Input)
+			bus = &data.inputs[0];
+		else if (isSidechainActive () && data.numInputs > 1 &&
+		         getSampleBuffers<SampleType> (data.inputs[1]))
+			bus = &data.inputs[1];
+		stream->process<SampleType> (bus, numSamples, processTiming);
 	}
 }
 
+//------------------------------------------------------------------------
+template <typename SampleType>
+void DataExchangeProcessor::processSamples (Vst::ProcessData& data)
+{
+	auto& input = data.inputs[0];
+	auto& output = data.outputs[0];
+
+	processStreams<SampleType> (data, false);
+	output.silenceFlags = passThroughChannels (getSampleBuffers<SampleType> (input),
+	                                           getSampleBuffers<SampleType> (output),
+	                                           input.numChannels, data.numSamples,
+	                                           input.silenceFlags);
+	processStreams<SampleType> (data, true);
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API DataExchangeProcessor::process (Vst::ProcessData& processData)
 {
+	[[maybe_unused]] RTSafetyCheckScope rtSafetyCheck;
+
 	if (processData.numSamples <= 0)
 		return kResultTrue;
 
-	if (currentExchangeBlock.blockID == Vst::InvalidDataExchangeBlockID)
-		acquireNewExchangeBlock ();
-
-	auto input = processData.inputs[0];
-	auto output = processData.outputs[0];
-
-	if (auto block = toDataBlock (currentExchangeBlock))
-	{
-		auto numSamples = static_cast<uint32> (processData.numSamples);
-		while (numSamples > 0)
-		{
-			uint32 numSamplesFreeInBlock = block->sampleRate - block->numSamples;
-			uint32 numSamplesToCopy = std::min<uint32> (numSamplesFreeInBlock, numSamples);
-			for (auto channel = 0; channel < input.numChannels; ++channel)
-			{
-				const auto channelOffset = channel * block->sampleRate;
-				auto blockChannelData = &block->samples[0] + block->numSamples + channelOffset;
-				auto inputChannel =
-				    input.channelBuffers32[channel] + (processData.numSamples - numSamples);
-				memcpy (blockChannelData, inputChannel, numSamplesToCopy * sizeof (float));
-			}
-			block->numSamples += numSamplesToCopy;
-			if (block->numSamples == block->sampleRate)
-			{
-				dataExchange->sendCurrentBlock ();
-				acquireNewExchangeBlock ();
-				block = toDataBlock (currentExchangeBlock);
-				if (block == nullptr)
-					break;
-			}
-			numSamples -= numSamplesToCopy;
-		}
-	}
-	for (auto channel = 0; channel < input.numChannels; ++channel)
-	{
-		if (output.channelBuffers32[channel] != input.channelBuffers32[channel])
-		{
-			memcpy (output.channelBuffers32[channel], input.channelBuffers32[channel],
-			        processData.numSamples * sizeof (float));
-		}
-		output.silenceFlags = input.silenceFlags;
-	}
+	updateProcessTiming (processData.processContext);
+	if (processSetup.symbolicSampleSize == Vst::kSample64)
+		processSamples<Vst::Sample64> (processData);
+	else
+		processSamples<Vst::Sample32> (processData);
 
 	return kResultOk;
 }
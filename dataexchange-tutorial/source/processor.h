@@ -4,15 +4,13 @@
 
 #pragma once
 
-#include "dataexchange.h"
+#include "exchangestream.h"
 #include "public.sdk/source/vst/vstaudioeffect.h"
+#include <memory>
+#include <vector>
 
 namespace Steinberg::Tutorial {
 
-//------------------------------------------------------------------------
-static constexpr Vst::DataExchangeBlock InvalidDataExchangeBlock = {
-    nullptr, 0, Vst::InvalidDataExchangeBlockID};
-
 //------------------------------------------------------------------------
 //  DataExchangeProcessor
 //------------------------------------------------------------------------
@@ -33,13 +31,34 @@ public:
 	tresult PLUGIN_API setActive (TBool state) override;
 	tresult PLUGIN_API canProcessSampleSize (int32 symbolicSampleSize) override;
 	tresult PLUGIN_API process (Vst::ProcessData& data) override;
+
+	/** Replaces all streams with one stream. */
+	void setStreamingConfig (const StreamingConfig& config) { setStreamingConfigs ({config}); }
+	const StreamingConfig& getStreamingConfig () const { return streamingConfigs.front (); }
+	const ExchangeStatistics& getStatistics () const { return getStatistics (0); }
+
+	/** One exchange queue per config, at least one, the index of a config is the userContextID
+	 *	of its queue. Call while inactive, the queues are opened on activation. */
+	void setStreamingConfigs (std::vector<StreamingConfig> configs);
+	uint32 getNumStreams () const { return static_cast<uint32> (streamingConfigs.size ()); }
+	const ExchangeStatistics& getStatistics (uint32 streamIndex) const;
+
 //------------------------------------------------------------------------
 protected:
-	void acquireNewExchangeBlock ();
+	void createStreams ();
+	void destroyStreams ();
+	uint16 getChannelCount (StreamSource source);
+	bool isSidechainActive ();
+	void updateProcessTiming (const Vst::ProcessContext* context);
+	template <typename SampleType>
+	void processSamples (Vst::ProcessData& data);
+	template <typename SampleType>
+	void processStreams (Vst::ProcessData& data, bool outputStreams);
 
-	std::unique_ptr<Vst::DataExchangeHandler> dataExchange;
-	Vst::DataExchangeBlock currentExchangeBlock {InvalidDataExchangeBlock};
-	uint16_t numChannels {0};
+	std::vector<StreamingConfig> streamingConfigs {StreamingConfig {}};
+	std::vector<std::unique_ptr<ExchangeStream>> streams;
+	Vst::IConnectionPoint* connectedPeer {nullptr};
+	ProcessTiming processTiming;
 };
 
 //------------------------------------------------------------------------
@@ -0,0 +1,372 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "sharedmemoryexchange.h"
+#include "base/source/fdebug.h"
+#include "pluginterfaces/vst/ivsthostapplication.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#define TUTORIAL_SHARED_MEMORY_EXCHANGE 1
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define TUTORIAL_SHARED_MEMORY_EXCHANGE 0
+#endif
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+constexpr auto kQueueOpenedMessageID = "TutorialSharedMemoryQueueOpened";
+constexpr auto kQueueClosedMessageID = "TutorialSharedMemoryQueueClosed";
+constexpr auto kNameAttribute = "Name";
+constexpr auto kSizeAttribute = "Size";
+
+constexpr uint32 kSlotAlignment = 64;
+
+//------------------------------------------------------------------------
+inline uint32 roundUp (uint32 value, uint32 alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+//------------------------------------------------------------------------
+inline std::string getName (Vst::IMessage* message)
+{
+	const void* data = nullptr;
+	uint32 size = 0;
+	auto attributes = message->getAttributes ();
+	if (!attributes || attributes->getBinary (kNameAttribute, data, size) != kResultTrue)
+		return {};
+	return std::string (static_cast<const char*> (data), size);
+}
+
+#if TUTORIAL_SHARED_MEMORY_EXCHANGE
+//------------------------------------------------------------------------
+// The futex is shared between processes, so it must not use FUTEX_PRIVATE_FLAG.
+//------------------------------------------------------------------------
+inline void futexWait (std::atomic<uint32>& word, uint32 expectedValue, long timeoutMilliseconds)
+{
+	timespec timeout {0, timeoutMilliseconds * 1000000};
+	syscall (SYS_futex, reinterpret_cast<uint32*> (&word), FUTEX_WAIT, expectedValue, &timeout,
+	         nullptr, 0);
+}
+
+//------------------------------------------------------------------------
+inline void futexWake (std::atomic<uint32>& word)
+{
+	syscall (SYS_futex, reinterpret_cast<uint32*> (&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+#endif // TUTORIAL_SHARED_MEMORY_EXCHANGE
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+// SharedMemoryExchangeHandler
+//------------------------------------------------------------------------
+bool SharedMemoryExchangeHandler::isSupported ()
+{
+	return TUTORIAL_SHARED_MEMORY_EXCHANGE != 0;
+}
+
+//------------------------------------------------------------------------
+void SharedMemoryExchangeHandler::onConnect (Vst::IConnectionPoint* other, FUnknown* context)
+{
+	peer = other;
+	hostContext = context;
+}
+
+//------------------------------------------------------------------------
+void SharedMemoryExchangeHandler::onDisconnect ()
+{
+	onDeactivate ();
+	peer = nullptr;
+	hostContext = nullptr;
+}
+
+//------------------------------------------------------------------------
+bool SharedMemoryExchangeHandler::onActivate (const Vst::DataExchangeHandler::Config& config)
+{
+	onDeactivate ();
+#if TUTORIAL_SHARED_MEMORY_EXCHANGE
+	if (!peer || config.blockSize == 0)
+		return false;
+
+	auto alignment = std::max (config.alignment, kSlotAlignment);
+	auto slotOffset = roundUp (sizeof (SharedRingHeader), alignment);
+	auto slotSize = roundUp (config.blockSize, alignment);
+	auto numBlocks = std::max<uint32> (config.numBlocks, 2);
+	auto size = slotOffset + static_cast<size_t> (slotSize) * numBlocks;
+
+	static std::atomic<uint32> queueCounter {0};
+	name = "/vst3-tutorial-dataexchange-" + std::to_string (getpid ()) + "-" +
+	       std::to_string (queueCounter++);
+	auto descriptor = shm_open (name.data (), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (descriptor < 0)
+		return false;
+	void* memory = MAP_FAILED;
+	if (ftruncate (descriptor, static_cast<off_t> (size)) == 0)
+	{
+		// populated, so the audio thread does not fault the pages in
+		memory = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		               descriptor, 0);
+	}
+	close (descriptor);
+	if (memory == MAP_FAILED)
+	{
+		shm_unlink (name.data ());
+		return false;
+	}
+
+	mappingSize = size;
+	header = new (memory) SharedRingHeader ();
+	header->magic = SharedRingHeader::kMagic;
+	header->version = SharedRingHeader::kVersion;
+	header->blockSize = config.blockSize;
+	header->numBlocks = numBlocks;
+	header->slotOffset = slotOffset;
+	header->slotSize = slotSize;
+	header->userContextID = config.userContextID;
+	slots = static_cast<uint8*> (memory) + slotOffset;
+	if (!sendMessage (kQueueOpenedMessageID))
+	{
+		unmap ();
+		return false;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+//------------------------------------------------------------------------
+void SharedMemoryExchangeHandler::onDeactivate ()
+{
+	if (!header)
+		return;
+	sendMessage (kQueueClosedMessageID);
+	unmap ();
+}
+
+//------------------------------------------------------------------------
+void SharedMemoryExchangeHandler::unmap ()
+{
+#if TUTORIAL_SHARED_MEMORY_EXCHANGE
+	munmap (header, mappingSize);
+	// the controller removes the name as soon as it has mapped the ring, but it may never have
+	shm_unlink (name.data ());
+#endif
+	header = nullptr;
+	slots = nullptr;
+	writeSlot = 0;
+	currentBlock = {nullptr, 0, Vst::InvalidDataExchangeBlockID};
+}
+
+//------------------------------------------------------------------------
+bool SharedMemoryExchangeHandler::sendMessage (const char* messageID)
+{
+	FUnknownPtr<Vst::IHostApplication> hostApplication (hostContext);
+	if (!hostApplication || !peer)
+		return false;
+	auto message = owned (Vst::allocateMessage (hostApplication));
+	if (!message)
+		return false;
+	message->setMessageID (messageID);
+	auto attributes = message->getAttributes ();
+	attributes->setBinary (kNameAttribute, name.data (), static_cast<uint32> (name.size ()));
+	attributes->setInt (kSizeAttribute, static_cast<int64> (mappingSize));
+	return peer->notify (message) == kResultTrue;
+}
+
+//------------------------------------------------------------------------
+Vst::DataExchangeBlock SharedMemoryExchangeHandler::getCurrentOrNewBlock ()
+{
+	if (currentBlock.data || !header)
+		return currentBlock;
+	// only the processor writes the write sequence
+	auto sequence = header->writeSequence.load (std::memory_order_relaxed);
+	if (sequence - header->readSequence.load (std::memory_order_acquire) >= header->numBlocks)
+		return currentBlock;
+	currentBlock = {slots + static_cast<size_t> (writeSlot) * header->slotSize, header->blockSize,
+	                writeSlot};
+	return currentBlock;
+}
+
+//------------------------------------------------------------------------
+bool SharedMemoryExchangeHandler::sendCurrentBlock ()
+{
+	if (!currentBlock.data)
+		return false;
+	currentBlock = {nullptr, 0, Vst::InvalidDataExchangeBlockID};
+	// not the sequence modulo numBlocks, that breaks when the sequence wraps
+	writeSlot = writeSlot + 1 == header->numBlocks ? 0 : writeSlot + 1;
+	// sequentially consistent with consumerWaiting, so either the controller sees the new block
+	// before it sleeps or the processor sees that it sleeps
+	auto sequence = header->writeSequence.load (std::memory_order_relaxed);
+	header->writeSequence.store (sequence + 1, std::memory_order_seq_cst);
+#if TUTORIAL_SHARED_MEMORY_EXCHANGE
+	if (header->consumerWaiting.load (std::memory_order_seq_cst))
+		futexWake (header->writeSequence);
+#endif
+	return true;
+}
+
+//------------------------------------------------------------------------
+// SharedMemoryReceiverHandler
+//------------------------------------------------------------------------
+bool SharedMemoryReceiverHandler::onMessage (Vst::IMessage* message)
+{
+	auto messageID = message->getMessageID ();
+	if (!messageID)
+		return false;
+	if (std::strcmp (messageID, kQueueOpenedMessageID) == 0)
+	{
+		int64 size = 0;
+		auto attributes = message->getAttributes ();
+		if (attributes && attributes->getInt (kSizeAttribute, size) == kResultTrue &&
+		    openQueue (getName (message), static_cast<uint64> (size)))
+			return true;
+		// not acknowledged, so the processor uses Vst::DataExchangeHandler instead
+		FDebugPrint ("Shared memory queue %s cannot be opened.\n", getName (message).data ());
+		return false;
+	}
+	if (std::strcmp (messageID, kQueueClosedMessageID) == 0)
+	{
+		// a late message of a previous queue must not close the current one
+		auto queueName = getName (message);
+		auto it = std::find_if (queues.begin (), queues.end (),
+		                        [&] (const auto& queue) { return queue->name == queueName; });
+		if (it != queues.end ())
+		{
+			closeQueue (**it, true);
+			queues.erase (it);
+		}
+		return true;
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------
+bool SharedMemoryReceiverHandler::openQueue (const std::string& queueName, uint64 size)
+{
+#if TUTORIAL_SHARED_MEMORY_EXCHANGE
+	if (queueName.empty () || size < sizeof (SharedRingHeader))
+		return false;
+	auto descriptor = shm_open (queueName.data (), O_RDWR, 0);
+	if (descriptor < 0)
+		return false;
+	auto memory = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+	                    descriptor, 0);
+	close (descriptor);
+	// nobody else needs the name, the memory is released with the last mapping
+	shm_unlink (queueName.data ());
+	if (memory == MAP_FAILED)
+		return false;
+
+	auto ring = static_cast<SharedRingHeader*> (memory);
+	auto requiredSize = ring->slotOffset + static_cast<uint64> (ring->slotSize) * ring->numBlocks;
+	if (ring->magic != SharedRingHeader::kMagic || ring->version != SharedRingHeader::kVersion ||
+	    ring->numBlocks == 0 || ring->blockSize > ring->slotSize || requiredSize > size)
+	{
+		munmap (memory, size);
+		return false;
+	}
+
+	// a stream which is opened again replaces its previous ring
+	auto it = std::find_if (queues.begin (), queues.end (), [&] (const auto& queue) {
+		return queue->header->userContextID == ring->userContextID;
+	});
+	if (it != queues.end ())
+	{
+		closeQueue (**it, true);
+		queues.erase (it);
+	}
+
+	auto queue = std::make_unique<Queue> ();
+	queue->name = queueName;
+	queue->header = ring;
+	queue->slots = static_cast<uint8*> (memory) + ring->slotOffset;
+	queue->mappingSize = size;
+	queue->blocks.resize (ring->numBlocks);
+	TBool dispatchOnBackgroundThread = true;
+	receiver->queueOpened (ring->userContextID, ring->blockSize, dispatchOnBackgroundThread);
+	queue->running = true;
+	queue->reader = std::thread ([this, queue = queue.get ()] () { run (*queue); });
+	queues.push_back (std::move (queue));
+	return true;
+#else
+	return false;
+#endif
+}
+
+//------------------------------------------------------------------------
+void SharedMemoryReceiverHandler::closeQueues (bool notify)
+{
+	for (auto& queue : queues)
+		closeQueue (*queue, notify);
+	queues.clear ();
+}
+
+//------------------------------------------------------------------------
+void SharedMemoryReceiverHandler::closeQueue (Queue& queue, bool notify)
+{
+#if TUTORIAL_SHARED_MEMORY_EXCHANGE
+	queue.running = false;
+	// a wake up racing with the reader going to sleep only delays it until the timeout
+	futexWake (queue.header->writeSequence);
+	queue.reader.join ();
+	if (notify)
+		receiver->queueClosed (queue.header->userContextID);
+	munmap (queue.header, queue.mappingSize);
+#endif
+	queue.header = nullptr;
+	queue.slots = nullptr;
+}
+
+//------------------------------------------------------------------------
+void SharedMemoryReceiverHandler::run (Queue& queue)
+{
+#if TUTORIAL_SHARED_MEMORY_EXCHANGE
+	constexpr long kTimeoutMilliseconds = 100;
+	auto header = queue.header;
+	auto readSequence = header->readSequence.load (std::memory_order_relaxed);
+	uint32 readSlot = 0;
+	while (queue.running.load (std::memory_order_relaxed))
+	{
+		auto writeSequence = header->writeSequence.load (std::memory_order_acquire);
+		auto numBlocks = std::min (writeSequence - readSequence, header->numBlocks);
+		if (numBlocks > 0)
+		{
+			// the blocks are read in place, the processor does not touch them until released
+			for (auto index = 0u; index < numBlocks; ++index)
+			{
+				auto slot = queue.slots + static_cast<size_t> (readSlot) * header->slotSize;
+				queue.blocks[index] = {slot, header->blockSize, readSlot};
+				readSlot = readSlot + 1 == header->numBlocks ? 0 : readSlot + 1;
+			}
+			receiver->onDataExchangeBlocksReceived (header->userContextID, numBlocks,
+			                                        queue.blocks.data (), true);
+			readSequence += numBlocks;
+			header->readSequence.store (readSequence, std::memory_order_release);
+			continue;
+		}
+
+		header->consumerWaiting.store (1, std::memory_order_seq_cst);
+		if (header->writeSequence.load (std::memory_order_seq_cst) == readSequence)
+			futexWait (header->writeSequence, readSequence, kTimeoutMilliseconds);
+		header->consumerWaiting.store (0, std::memory_order_relaxed);
+	}
+#endif
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "public.sdk/source/vst/utility/dataexchange.h"
+#include "pluginterfaces/vst/ivstdataexchange.h"
+#include "pluginterfaces/vst/ivstmessage.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------
+// Data exchange through a shared memory ring, for hosts without IDataExchangeHandler.
+//
+// The processor creates the ring when it is activated and sends its name to the controller in an
+// IMessage, the controller maps it and reads the blocks in place. Only the names of the queues are
+// sent as messages, the blocks are never copied. Available on Linux, where the controller thread
+// sleeps on a futex; isSupported returns false elsewhere.
+//------------------------------------------------------------------------
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+/** Start of the shared memory, followed by numBlocks slots of slotSize bytes.
+ *
+ *	The sequences count the blocks sent and released since the ring was created and wrap around
+ *	at 2^32. Both sides start at slot 0 and use the slots in order, each keeps its own slot index
+ *	which wraps at numBlocks. The block ID is the slot index. */
+struct SharedRingHeader
+{
+	static constexpr uint32 kMagic = 0x4D535844;
+	static constexpr uint32 kVersion = 1;
+
+	uint32 magic;
+	uint32 version;
+	uint32 blockSize;
+	uint32 numBlocks;
+	// from the start of the header
+	uint32 slotOffset;
+	uint32 slotSize;
+	uint32 userContextID;
+	// written by the processor, the controller sleeps on it
+	alignas (64) std::atomic<uint32> writeSequence;
+	// written by the controller
+	alignas (64) std::atomic<uint32> readSequence;
+	std::atomic<uint32> consumerWaiting;
+};
+
+static_assert (std::atomic<uint32>::is_always_lock_free, "the ring needs address free atomics");
+
+//------------------------------------------------------------------------
+/** Processor side, used like Vst::DataExchangeHandler. */
+class SharedMemoryExchangeHandler
+{
+public:
+	~SharedMemoryExchangeHandler () noexcept { onDeactivate (); }
+
+	static bool isSupported ();
+
+	void onConnect (Vst::IConnectionPoint* other, FUnknown* hostContext);
+	void onDisconnect ();
+	/** Creates the ring and announces it to the controller. Returns false if this fails or the
+	 *	controller does not acknowledge it, the processor uses Vst::DataExchangeHandler then. */
+	bool onActivate (const Vst::DataExchangeHandler::Config& config);
+	void onDeactivate ();
+	bool isActive () const { return header != nullptr; }
+
+	/** Audio thread: the block to write into, invalid if the controller did not release one. */
+	Vst::DataExchangeBlock getCurrentOrNewBlock ();
+	/** Audio thread: wakes the controller with a futex syscall only if it waits. */
+	bool sendCurrentBlock ();
+
+//------------------------------------------------------------------------
+private:
+	bool sendMessage (const char* messageID);
+	void unmap ();
+
+	Vst::IConnectionPoint* peer {nullptr};
+	FUnknown* hostContext {nullptr};
+	std::string name;
+	SharedRingHeader* header {nullptr};
+	uint8* slots {nullptr};
+	size_t mappingSize {0};
+	// the slot of the next block, follows the write sequence
+	uint32 writeSlot {0};
+	Vst::DataExchangeBlock currentBlock {nullptr, 0, Vst::InvalidDataExchangeBlockID};
+};
+
+//------------------------------------------------------------------------
+/** Controller side, used like Vst::DataExchangeReceiverHandler. Every queue has its own reader
+ *	thread, the receiver is called on it no matter which thread it asks for in queueOpened. */
+class SharedMemoryReceiverHandler
+{
+public:
+	SharedMemoryReceiverHandler (Vst::IDataExchangeReceiver* receiver) : receiver (receiver) {}
+	~SharedMemoryReceiverHandler () noexcept { closeQueues (false); }
+
+	/** Returns true if the message belonged to the shared memory exchange, false as well if its
+	 *	queue could not be opened. */
+	bool onMessage (Vst::IMessage* message);
+	/** Stops reading and unmaps all rings, calls queueClosed if notify is set. */
+	void closeQueues (bool notify = true);
+
+//------------------------------------------------------------------------
+private:
+	struct Queue
+	{
+		std::string name;
+		SharedRingHeader* header {nullptr};
+		uint8* slots {nullptr};
+		size_t mappingSize {0};
+		std::thread reader;
+		std::atomic<bool> running {false};
+		std::vector<Vst::DataExchangeBlock> blocks;
+	};
+
+	bool openQueue (const std::string& name, uint64 size);
+	void closeQueue (Queue& queue, bool notify);
+	void run (Queue& queue);
+
+	Vst::IDataExchangeReceiver* receiver;
+	// only changed by the thread which receives the messages
+	std::vector<std::unique_ptr<Queue>> queues;
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
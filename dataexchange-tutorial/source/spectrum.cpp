@@ -0,0 +1,158 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "spectrum.h"
+#include <algorithm>
+#include <cmath>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+//------------------------------------------------------------------------
+double getWindowValue (WindowType type, uint32 index, uint32 size)
+{
+	auto phase = 2. * kPi * index / size;
+	switch (type)
+	{
+		case WindowType::Hann:
+			return 0.5 - 0.5 * std::cos (phase);
+		case WindowType::BlackmanHarris:
+			return 0.35875 - 0.48829 * std::cos (phase) + 0.14128 * std::cos (2. * phase) -
+			       0.01168 * std::cos (3. * phase);
+		default:
+			return 1.;
+	}
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+bool SpectrumAnalyzer::setup (double newSampleRate, const SpectrumConfig& newConfig)
+{
+	if (newConfig.fftSize < 512 || newConfig.fftSize > 32768 || newSampleRate <= 0.)
+		return false;
+	if (!fft.setup (newConfig.fftSize))
+		return false;
+
+	config = newConfig;
+	config.overlap = std::min<uint32> (std::max<uint32> (config.overlap, 1), 16);
+	sampleRate = newSampleRate;
+	auto fftSize = config.fftSize;
+	hopSize = fftSize / config.overlap;
+
+	window.resize (fftSize);
+	double windowSum = 0.;
+	for (auto index = 0u; index < fftSize; ++index)
+	{
+		window[index] = static_cast<float> (getWindowValue (config.window, index, fftSize));
+		windowSum += window[index];
+	}
+	// a sine with amplitude 1 gives a bin with power 1
+	powerScale = static_cast<float> (4. / (windowSum * windowSum));
+
+	history.assign (fftSize, 0.f);
+	frame.assign (fftSize, 0.f);
+	real.assign (fftSize / 2 + 1, 0.f);
+	imag.assign (fftSize / 2 + 1, 0.f);
+
+	auto lastBin = fftSize / 2;
+	for (auto bin = 0u; bin < kNumDisplayBins; ++bin)
+	{
+		auto low = getDisplayBinFrequency (bin, sampleRate) * fftSize / sampleRate;
+		auto high = getDisplayBinFrequency (bin + 1, sampleRate) * fftSize / sampleRate;
+		firstFFTBin[bin] = std::min (static_cast<uint32> (std::lround (low)), lastBin);
+		lastFFTBin[bin] = std::min (static_cast<uint32> (std::lround (high)), lastBin);
+		lastFFTBin[bin] = std::max (lastFFTBin[bin], firstFFTBin[bin]);
+	}
+	reset ();
+	return true;
+}
+
+//------------------------------------------------------------------------
+void SpectrumAnalyzer::reset ()
+{
+	std::fill (history.begin (), history.end (), 0.f);
+	historyPosition = 0;
+	samplesUntilTransform = hopSize;
+	displayPower.fill (0.f);
+	numTransforms = 0;
+}
+
+//------------------------------------------------------------------------
+double SpectrumAnalyzer::getDisplayBinFrequency (uint32 bin, double sampleRate)
+{
+	auto maxFrequency = sampleRate * 0.5;
+	return kMinFrequency * std::pow (maxFrequency / kMinFrequency,
+	                                 static_cast<double> (bin) / kNumDisplayBins);
+}
+
+//------------------------------------------------------------------------
+void SpectrumAnalyzer::process (const float* samples, uint32 numSamples)
+{
+	auto fftSize = config.fftSize;
+	while (numSamples > 0)
+	{
+		auto count = std::min (samplesUntilTransform, numSamples);
+		count = std::min (count, fftSize - historyPosition);
+		std::copy_n (samples, count, history.data () + historyPosition);
+		historyPosition = (historyPosition + count) % fftSize;
+		samples += count;
+		numSamples -= count;
+		samplesUntilTransform -= count;
+		if (samplesUntilTransform == 0)
+		{
+			transform ();
+			samplesUntilTransform = hopSize;
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+void SpectrumAnalyzer::transform ()
+{
+	// the oldest sample is at the write position of the ring
+	auto fftSize = config.fftSize;
+	auto numOlder = fftSize - historyPosition;
+	for (auto index = 0u; index < numOlder; ++index)
+		frame[index] = history[historyPosition + index] * window[index];
+	for (auto index = 0u; index < historyPosition; ++index)
+		frame[numOlder + index] = history[index] * window[numOlder + index];
+
+	fft.forward (frame.data (), real.data (), imag.data ());
+
+	for (auto bin = 0u; bin < kNumDisplayBins; ++bin)
+	{
+		float maxPower = 0.f;
+		for (auto fftBin = firstFFTBin[bin]; fftBin <= lastFFTBin[bin]; ++fftBin)
+		{
+			auto power = real[fftBin] * real[fftBin] + imag[fftBin] * imag[fftBin];
+			maxPower = std::max (maxPower, power);
+		}
+		displayPower[bin] += maxPower * powerScale;
+	}
+	++numTransforms;
+}
+
+//------------------------------------------------------------------------
+bool SpectrumAnalyzer::takeSpectrum (float* displayBins)
+{
+	if (numTransforms == 0)
+		return false;
+	for (auto bin = 0u; bin < kNumDisplayBins; ++bin)
+	{
+		auto power = displayPower[bin] / numTransforms;
+		displayBins[bin] = power > 0.f ? 10.f * std::log10 (power) : kSilence;
+		displayBins[bin] = std::max (displayBins[bin], kSilence);
+	}
+	displayPower.fill (0.f);
+	numTransforms = 0;
+	return true;
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
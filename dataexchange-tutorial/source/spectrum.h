@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "fft.h"
+#include <array>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+enum class WindowType
+{
+	Rectangular,
+	Hann,
+	BlackmanHarris,
+};
+
+//------------------------------------------------------------------------
+struct SpectrumConfig
+{
+	// power of two, 512 to 32768
+	uint32 fftSize {4096};
+	// number of transforms per fftSize samples, 1 to 16
+	uint32 overlap {4};
+	WindowType window {WindowType::Hann};
+};
+
+//------------------------------------------------------------------------
+/** Short time Fourier transform of a mono signal, reduced to logarithmically spaced display bins.
+ *
+ *	A transform of the last fftSize samples runs every fftSize / overlap samples. The power of every
+ *	display bin is the largest power of the FFT bins it covers, averaged over the transforms since
+ *	the spectrum was taken the last time. setup allocates, process does not. */
+class SpectrumAnalyzer
+{
+public:
+	static constexpr uint32 kNumDisplayBins = 128;
+	static constexpr double kMinFrequency = 20.;
+	static constexpr float kSilence = -200.f;
+
+	bool setup (double sampleRate, const SpectrumConfig& config);
+	void reset ();
+
+	void process (const float* samples, uint32 numSamples);
+
+	/** Writes kNumDisplayBins levels in dBFS (a full scale sine reads 0 dB). Returns false if there
+	 *	was no transform since the last call. */
+	bool takeSpectrum (float* displayBins);
+
+	/** Lower edge of a display bin in Hz. */
+	static double getDisplayBinFrequency (uint32 bin, double sampleRate);
+
+	double getSampleRate () const { return sampleRate; }
+	const SpectrumConfig& getConfig () const { return config; }
+
+//------------------------------------------------------------------------
+private:
+	void transform ();
+
+	FFT fft;
+	SpectrumConfig config;
+	double sampleRate {0.};
+	uint32 hopSize {0};
+
+	std::vector<float> window;
+	// ring of the last fftSize input samples
+	std::vector<float> history;
+	uint32 historyPosition {0};
+	uint32 samplesUntilTransform {0};
+
+	std::vector<float> frame;
+	std::vector<float> real;
+	std::vector<float> imag;
+	float powerScale {1.f};
+
+	std::array<uint32, kNumDisplayBins> firstFFTBin {};
+	std::array<uint32, kNumDisplayBins> lastFFTBin {};
+	std::array<float, kNumDisplayBins> displayPower {};
+	uint32 numTransforms {0};
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
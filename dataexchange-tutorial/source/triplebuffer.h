@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "pluginterfaces/base/ftypes.h"
+#include <array>
+#include <atomic>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+/** Hands the latest value of one writer thread to one reader thread without locks. */
+template <typename T>
+class TripleBuffer
+{
+public:
+	void write (const T& value)
+	{
+		slots[back] = value;
+		back = middle.exchange (back | kNewValue, std::memory_order_acq_rel) & kIndexMask;
+	}
+
+	/** Returns false if nothing was written since the last read. */
+	bool read (T& value)
+	{
+		if ((middle.load (std::memory_order_relaxed) & kNewValue) == 0)
+			return false;
+		front = middle.exchange (front, std::memory_order_acq_rel) & kIndexMask;
+		value = slots[front];
+		return true;
+	}
+
+private:
+	static constexpr uint8 kIndexMask = 0x3;
+	static constexpr uint8 kNewValue = 0x4;
+
+	std::array<T, 3> slots {};
+	uint8 front {0};
+	std::atomic<uint8> middle {1};
+	uint8 back {2};
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,314 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#include "waveformoverview.h"
+#include <algorithm>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+namespace {
+
+//------------------------------------------------------------------------
+/** Range of numFrames frames of one channel of a block. */
+WaveformRange getFramesRange (const DataBlock* block, uint32 channel, uint32 frame,
+                              uint32 numFrames)
+{
+	WaveformRange range;
+	auto stride = block->frameStride;
+	switch (block->payloadFormat)
+	{
+		case PayloadFormat::Decimated:
+		{
+			auto points = getChannelData<DecimatedPoint> (block, channel) + frame * stride;
+			for (auto index = 0u; index < numFrames; ++index)
+				range.merge ({points[index * stride].min, points[index * stride].max});
+			break;
+		}
+		case PayloadFormat::Int16:
+		{
+			auto values = getChannelData<int16_t> (block, channel) + frame * stride;
+			int32 lowest = 32767;
+			int32 highest = -32767;
+			for (auto index = 0u; index < numFrames; ++index)
+			{
+				lowest = std::min<int32> (lowest, values[index * stride]);
+				highest = std::max<int32> (highest, values[index * stride]);
+			}
+			if (numFrames > 0)
+				range = {lowest / 32767.f, highest / 32767.f};
+			break;
+		}
+		default:
+		{
+			auto values = getChannelSamples (block, channel) + frame * stride;
+			for (auto index = 0u; index < numFrames; ++index)
+			{
+				range.min = std::min (range.min, values[index * stride]);
+				range.max = std::max (range.max, values[index * stride]);
+			}
+			break;
+		}
+	}
+	return range;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+void WaveformOverview::reset (const OverviewConfig& newConfig, uint32 channelCount)
+{
+	config = newConfig;
+	config.samplesPerEntry = std::max<uint32> (config.samplesPerEntry, 1);
+	started = false;
+	// the chunks hold the entries of all channels
+	for (auto& level : levels)
+		level.chunks.clear ();
+	freeChunks.clear ();
+	arena.clear ();
+	numChannels = channelCount;
+
+	// chunks are released before new ones are allocated, so every level needs the chunks of the
+	// window, one partly before it and the one being filled
+	uint64 numChunks = 0;
+	if (config.retentionSamples > 0 && numChannels > 0)
+	{
+		for (auto levelIndex = 0u; levelIndex < kMaxLevels; ++levelIndex)
+			numChunks += config.retentionSamples / (getEntrySpan (levelIndex) * kChunkEntries) + 2;
+	}
+	arena.reserve (numChunks);
+	freeChunks.reserve (numChunks);
+	for (auto index = 0u; index < numChunks; ++index)
+	{
+		arena.push_back (std::make_unique<WaveformRange[]> (kChunkEntries * numChannels));
+		freeChunks.push_back (arena.back ().get ());
+	}
+	restart (0);
+}
+
+//------------------------------------------------------------------------
+void WaveformOverview::restart (uint64 position)
+{
+	for (auto& level : levels)
+	{
+		for (auto chunk : level.chunks)
+			freeChunks.push_back (chunk);
+		level.chunks.clear ();
+		level.firstEntry = 0;
+		level.numEntries = 0;
+		level.pending.assign (numChannels, {});
+		level.numPending = 0;
+	}
+	current.assign (numChannels, {});
+	currentSamples = 0;
+	startPosition = position;
+	endPosition = position;
+}
+
+//------------------------------------------------------------------------
+void WaveformOverview::append (const DataBlock* block)
+{
+	// stereo points carry no waveform
+	if (block->numChannels == 0 || block->numChannels != numChannels || block->numSamples == 0 ||
+	    block->payloadFormat == PayloadFormat::Stereo)
+		return;
+	// a reactivated processor counts from 0 again
+	if (!started || block->samplePosition < endPosition)
+	{
+		restart (block->samplePosition);
+		started = true;
+	}
+	auto gap = block->samplePosition - endPosition;
+	if (config.retentionSamples > 0 && gap >= config.retentionSamples)
+		restart (block->samplePosition);
+	else if (gap > 0)
+		appendSilence (gap);
+
+	uint64 samplesPerFrame = std::max<uint16> (block->decimation, 1);
+	auto frame = 0u;
+	while (frame < block->numSamples)
+	{
+		// the frames which complete the current entry, a decimated point may complete several
+		auto samplesNeeded = config.samplesPerEntry - currentSamples;
+		auto framesNeeded = (samplesNeeded + samplesPerFrame - 1) / samplesPerFrame;
+		auto numFrames = static_cast<uint32> (
+		    std::min<uint64> (block->numSamples - frame, framesNeeded));
+		for (auto channel = 0u; channel < numChannels; ++channel)
+			current[channel].merge (getFramesRange (block, channel, frame, numFrames));
+		frame += numFrames;
+		currentSamples += numFrames * samplesPerFrame;
+		endPosition += numFrames * samplesPerFrame;
+
+		while (currentSamples >= config.samplesPerEntry)
+		{
+			completeEntry ();
+			// the rest of the last frame belongs to the next entry
+			if (currentSamples > 0)
+			{
+				for (auto channel = 0u; channel < numChannels; ++channel)
+					current[channel] = getFramesRange (block, channel, frame - 1, 1);
+			}
+		}
+	}
+	releaseChunks ();
+}
+
+//------------------------------------------------------------------------
+void WaveformOverview::appendSilence (uint64 numSamples)
+{
+	// nothing was received, the entries stay empty but keep their place
+	endPosition += numSamples;
+	currentSamples += numSamples;
+	while (currentSamples >= config.samplesPerEntry)
+		completeEntry ();
+}
+
+//------------------------------------------------------------------------
+void WaveformOverview::completeEntry ()
+{
+	pushEntry (0, current.data ());
+	current.assign (numChannels, {});
+	currentSamples -= config.samplesPerEntry;
+}
+
+//------------------------------------------------------------------------
+void WaveformOverview::pushEntry (uint32 levelIndex, const WaveformRange* ranges)
+{
+	auto& level = levels[levelIndex];
+	auto indexInChunk = static_cast<uint32> (level.numEntries % kChunkEntries);
+	if (indexInChunk == 0)
+	{
+		// a long gap fills many entries at once, chunks before the window go first
+		releaseChunks ();
+		level.chunks.push_back (allocateChunk ());
+	}
+	std::copy (ranges, ranges + numChannels, level.chunks.back () + indexInChunk * numChannels);
+	++level.numEntries;
+
+	// every kLevelFactor entries make one entry of the level above
+	if (levelIndex + 1 == kMaxLevels)
+		return;
+	for (auto channel = 0u; channel < numChannels; ++channel)
+		level.pending[channel].merge (ranges[channel]);
+	if (++level.numPending < kLevelFactor)
+		return;
+	pushEntry (levelIndex + 1, level.pending.data ());
+	level.pending.assign (numChannels, {});
+	level.numPending = 0;
+}
+
+//------------------------------------------------------------------------
+WaveformRange* WaveformOverview::allocateChunk ()
+{
+	if (!freeChunks.empty ())
+	{
+		auto chunk = freeChunks.back ();
+		freeChunks.pop_back ();
+		return chunk;
+	}
+	// only without a retention window
+	arena.push_back (std::make_unique<WaveformRange[]> (kChunkEntries * numChannels));
+	return arena.back ().get ();
+}
+
+//------------------------------------------------------------------------
+void WaveformOverview::releaseChunks ()
+{
+	if (config.retentionSamples == 0)
+		return;
+	auto appended = endPosition - startPosition;
+	if (appended <= config.retentionSamples)
+		return;
+	auto firstKept = appended - config.retentionSamples;
+	for (auto levelIndex = 0u; levelIndex < kMaxLevels; ++levelIndex)
+	{
+		// a chunk is released when all its entries lie before the window
+		auto& level = levels[levelIndex];
+		auto chunkSpan = getEntrySpan (levelIndex) * kChunkEntries;
+		while (level.chunks.size () > 1 &&
+		       (level.firstEntry + kChunkEntries) * getEntrySpan (levelIndex) <= firstKept)
+		{
+			freeChunks.push_back (level.chunks.front ());
+			level.chunks.pop_front ();
+			level.firstEntry += kChunkEntries;
+		}
+		if (chunkSpan > appended)
+			break;
+	}
+}
+
+//------------------------------------------------------------------------
+WaveformRange WaveformOverview::queryRange (uint32 channel, uint32 levelIndex, uint64 begin,
+                                            uint64 end) const
+{
+	// the coarse levels lag behind by up to kLevelFactor - 1 entries of each level below, the
+	// finer levels fill in the end
+	WaveformRange range;
+	for (auto index = static_cast<int32> (levelIndex); index >= 0; --index)
+	{
+		const auto& level = levels[index];
+		auto span = getEntrySpan (index);
+		auto firstEntry = std::max (begin / span, level.firstEntry);
+		auto endEntry = std::min ((end + span - 1) / span, level.numEntries);
+		for (auto entry = firstEntry; entry < endEntry; ++entry)
+		{
+			auto offset = entry - level.firstEntry;
+			auto chunk = level.chunks[offset / kChunkEntries];
+			range.merge (chunk[(offset % kChunkEntries) * numChannels + channel]);
+		}
+		auto covered = level.numEntries * span;
+		if (end <= covered)
+			break;
+		begin = std::max (begin, covered);
+	}
+	return range;
+}
+
+//------------------------------------------------------------------------
+bool WaveformOverview::render (uint32 channel, uint64 begin, uint64 end, WaveformRange* pixels,
+                               uint32 numPixels) const
+{
+	if (channel >= numChannels || numPixels == 0)
+		return false;
+	std::fill (pixels, pixels + numPixels, WaveformRange {});
+	begin = std::max (begin, startPosition);
+	if (end <= begin)
+		return true;
+
+	// the coarsest level whose entries are not wider than a pixel
+	auto samplesPerPixel = (end - begin) / numPixels;
+	auto levelIndex = 0u;
+	while (levelIndex + 1 < kMaxLevels && getEntrySpan (levelIndex + 1) <= samplesPerPixel &&
+	       levels[levelIndex + 1].numEntries > 0)
+		++levelIndex;
+
+	for (auto pixel = 0u; pixel < numPixels; ++pixel)
+	{
+		auto pixelBegin = begin + (end - begin) * pixel / numPixels;
+		auto pixelEnd = begin + (end - begin) * (pixel + 1) / numPixels;
+		if (pixelEnd > pixelBegin)
+		{
+			pixels[pixel] = queryRange (channel, levelIndex, pixelBegin - startPosition,
+			                            pixelEnd - startPosition);
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+void WaveformOverview::getPositions (uint64& begin, uint64& end) const
+{
+	begin = startPosition + levels[0].firstEntry * getEntrySpan (0);
+	end = endPosition;
+}
+
+//------------------------------------------------------------------------
+uint64 WaveformOverview::getMemorySize () const
+{
+	return static_cast<uint64> (arena.size ()) * kChunkEntries * numChannels *
+	       sizeof (WaveformRange);
+}
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2023 Steinberg Media Technologies.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include "dataexchange.h"
+#include <array>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace Steinberg::Tutorial {
+
+//------------------------------------------------------------------------
+/** Lowest and highest sample of a range, min > max where nothing was received. */
+struct WaveformRange
+{
+	float min {std::numeric_limits<float>::max ()};
+	float max {std::numeric_limits<float>::lowest ()};
+
+	bool isEmpty () const { return min > max; }
+	void merge (const WaveformRange& other)
+	{
+		min = std::min (min, other.min);
+		max = std::max (max, other.max);
+	}
+};
+
+//------------------------------------------------------------------------
+struct OverviewConfig
+{
+	// input samples of one entry of the finest level, views zoomed in further need the audio
+	uint32 samplesPerEntry {256};
+	// samples kept, older ones are released chunk by chunk; 0 keeps everything
+	uint64 retentionSamples {uint64 {48000} * 60 * 60};
+};
+
+//------------------------------------------------------------------------
+/** Min/max pyramid over the received stream, for waveform views of long recordings.
+ *
+ *	Every level has a quarter of the entries of the level below, so a view of any length reads at
+ *	most a few entries per pixel. The entries live in chunks of kChunkEntries which are reused once
+ *	they fall out of the retention window. reset allocates the chunks for the whole window up
+ *	front, so appending does not allocate.
+ *
+ *	Not thread safe. The BlockAnalyzer worker appends and renders, the UI thread gets the rendered
+ *	pixels with the analysis results. */
+class WaveformOverview
+{
+public:
+	static constexpr uint32 kLevelFactor = 4;
+	static constexpr uint32 kMaxLevels = 16;
+	static constexpr uint32 kChunkEntries = 4096;
+
+	/** Clears the overview and allocates the chunks of the retention window for numChannels
+	 *	channels, the next block starts it again. With a retentionSamples of 0 the chunks are
+	 *	allocated while appending. */
+	void reset (const OverviewConfig& config, uint32 numChannels);
+
+	/** Appends the samples of a block in amortized constant time per sample. Gaps in the sample
+	 *	positions stay empty; a block from before the end starts the overview again. Blocks of
+	 *	another channel count than reset are ignored. */
+	void append (const DataBlock* block);
+
+	/** Writes numPixels ranges of a channel between the sample positions begin and end. Returns
+	 *	false if the channel does not exist. */
+	bool render (uint32 channel, uint64 begin, uint64 end, WaveformRange* pixels,
+	             uint32 numPixels) const;
+	/** Positions of the first kept and after the last appended sample. */
+	void getPositions (uint64& begin, uint64& end) const;
+	uint32 getNumChannels () const { return numChannels; }
+	uint64 getMemorySize () const;
+
+//------------------------------------------------------------------------
+private:
+	struct Level
+	{
+		// the first chunk holds entry firstEntry
+		std::deque<WaveformRange*> chunks;
+		uint64 firstEntry {0};
+		uint64 numEntries {0};
+		// merged entries of the level below which do not make a full entry yet
+		std::vector<WaveformRange> pending;
+		uint32 numPending {0};
+	};
+
+	void restart (uint64 position);
+	void appendSilence (uint64 numSamples);
+	void completeEntry ();
+	void pushEntry (uint32 levelIndex, const WaveformRange* ranges);
+	void releaseChunks ();
+	WaveformRange* allocateChunk ();
+	WaveformRange queryRange (uint32 channel, uint32 levelIndex, uint64 begin, uint64 end) const;
+	uint64 getEntrySpan (uint32 levelIndex) const
+	{
+		return uint64 {config.samplesPerEntry} << (2 * levelIndex);
+	}
+
+	OverviewConfig config;
+	uint32 numChannels {0};
+	// position of the first sample of entry 0 and after the last appended sample
+	uint64 startPosition {0};
+	uint64 endPosition {0};
+	bool started {false};
+
+	// the entry of the finest level in progress
+	std::vector<WaveformRange> current;
+	uint64 currentSamples {0};
+
+	std::array<Level, kMaxLevels> levels;
+	std::vector<std::unique_ptr<WaveformRange[]>> arena;
+	std::vector<WaveformRange*> freeChunks;
+};
+
+//------------------------------------------------------------------------
+} // Steinberg::Tutorial